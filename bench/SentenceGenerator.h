@@ -0,0 +1,117 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+#include <random>
+
+namespace csa {
+
+/**
+ * @brief Generate random sentences of a grammar as terminal id streams.
+ *
+ * Every sentence is a random leftmost derivation from the start symbol, and ends with eof.
+ * When the derivation gets too deep or too long, every nonterminal takes its production
+ * with the shortest yield, so the derivation always terminates.
+ */
+class SentenceGenerator {
+public:
+    static constexpr std::size_t infinity = static_cast<std::size_t>(-1);
+
+    SentenceGenerator(GrammarContextPtr gc, unsigned seed = 1, std::size_t maxDepth = 64,
+                      std::size_t maxLength = 4096)
+        : gc_(gc), random_(seed), maxDepth_(maxDepth), maxLength_(maxLength) {
+        auto &pl = gc_->pl->table();
+        auto symbolCount = gc_->st->symbolCount();
+        productionsOf_.resize(symbolCount);
+        for (auto &p : pl) { productionsOf_[p.lhs.symbol->id()].push_back(p.id); }
+
+        // Compute the shortest yield of every symbol by fixpoint.
+        minLength_.assign(symbolCount, infinity);
+        minProduction_.assign(symbolCount, -1);
+        for (auto symbol : gc_->st->table()) {
+            if (symbol->isTerminal()) { minLength_[symbol->id()] = symbol->isTerminalEpsilon() ? 0 : 1; }
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto &p : pl) {
+                std::size_t length = 0;
+                for (auto symbol : p.rhs.symbolList) {
+                    auto n = minLength_[symbol->id()];
+                    length = (n == infinity || length == infinity) ? infinity : length + n;
+                }
+                auto lhs = p.lhs.symbol->id();
+                if (length < minLength_[lhs]) {
+                    minLength_[lhs] = length;
+                    minProduction_[lhs] = p.id;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Check if the start symbol derives some sentence.
+     */
+    bool good() const {
+        auto &pl = gc_->pl->table();
+        return !pl.empty() && minLength_[pl.front().lhs.symbol->id()] != infinity;
+    }
+
+    /**
+     * @brief Append a random sentence to the output.
+     */
+    void generate(std::vector<SymbolId> &out) {
+        auto &pl = gc_->pl->table();
+        auto begin = out.size();
+        stack_.clear();
+        stack_.push_back(pl.front().lhs.symbol);
+
+        while (!stack_.empty()) {
+            auto symbol = stack_.back();
+            stack_.pop_back();
+            if (symbol->isTerminal()) {
+                if (!symbol->isTerminalEpsilon()) { out.push_back(symbol->id()); }
+                continue;
+            }
+
+            auto id = symbol->id();
+            auto pid = minProduction_[id];
+            if (stack_.size() < maxDepth_ && out.size() - begin < maxLength_) {
+                // Choose among the productions which can terminate.
+                auto &productions = productionsOf_[id];
+                auto candidate = productions[random_() % productions.size()];
+                if (isTerminable(pl[candidate])) { pid = candidate; }
+            }
+
+            auto &symbolList = pl[pid].rhs.symbolList;
+            stack_.insert(stack_.end(), symbolList.rbegin(), symbolList.rend());
+        }
+    }
+
+private:
+    bool isTerminable(const Production &p) const {
+        for (auto symbol : p.rhs.symbolList) {
+            if (minLength_[symbol->id()] == infinity) { return false; }
+        }
+        return true;
+    }
+
+    GrammarContextPtr gc_;
+    std::mt19937 random_;
+    std::size_t maxDepth_;
+    std::size_t maxLength_;
+    std::vector<std::vector<int>> productionsOf_;    ///< Symbol id mapping its production ids.
+    std::vector<std::size_t> minLength_;             ///< Symbol id mapping its shortest yield.
+    std::vector<int> minProduction_;                 ///< Symbol id mapping the production of the shortest yield.
+    std::vector<SymbolPtr> stack_;
+};
+
+}    // namespace csa
@@ -0,0 +1,86 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1Analyzer.h"
+#include "LL1Engine.h"
+#include "SentenceGenerator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace csa;
+
+//
+// Usage: bench01_LL1Engine [token-count] [grammar-file]
+//
+// Parse random sentences of a LL(1) grammar with the table-driven engine, and report tokens/sec.
+//
+int main(int argc, char *argv[]) {
+    std::string stream = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E )
+F   -> id
+)";
+
+    std::size_t tokenCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    auto gc = argc > 2 ? GrammarContextBuilder::buildFromFile(std::string(argv[2]))
+                       : GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) { return 1; }
+
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+    if (!theLL1Analyzer.isValidLL1()) { printf("warning, the grammar is not LL(1), some input is rejected.\n"); }
+
+    SentenceGenerator generator(gc);
+    if (!generator.good()) {
+        printf("error, the grammar derives no sentence.\n");
+        return 1;
+    }
+
+    // Generate the input, and remember where every sentence begins.
+    std::vector<SymbolId> terminals;
+    std::vector<std::size_t> sentenceBegin{0};
+    terminals.reserve(tokenCount + 4096);
+    while (terminals.size() < tokenCount) {
+        generator.generate(terminals);
+        sentenceBegin.push_back(terminals.size());
+    }
+    auto sentenceCount = sentenceBegin.size() - 1;
+
+    LL1Engine engine(gc, theLL1Analyzer.ll1Table());
+    std::size_t acceptedCount = 0;
+    std::size_t productionCount = 0;
+    std::size_t consumedCount = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < sentenceCount; ++i) {
+        auto status = engine.parse(terminals.data() + sentenceBegin[i], sentenceBegin[i + 1] - sentenceBegin[i]);
+        if (status == LL1Engine::Status::accepted) { ++acceptedCount; }
+        productionCount += engine.productions().size();
+        consumedCount += engine.consumedCount();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    std::cout << "tokens      : " << terminals.size() << " (" << consumedCount << " consumed)\n";
+    std::cout << "sentences   : " << sentenceCount << " (" << acceptedCount << " accepted)\n";
+    std::cout << "productions : " << productionCount << "\n";
+    std::cout << "seconds     : " << seconds.count() << "\n";
+    std::cout << "tokens/sec  : " << static_cast<std::size_t>(consumedCount / seconds.count()) << "\n";
+
+    return acceptedCount == sentenceCount ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1Analyzer.h"
+#include "LL1Engine.h"
+#include "SentenceGenerator.h"
+#include "ExprParser.h"    // Generated from BENCH_GRAMMAR_FILE by cpp-syntax-analyzer --generate.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace csa;
+
+//
+// Usage: bench02_RecursiveDescent [token-count]
+//
+// Parse the same random sentences with the table-driven engine and the generated
+// recursive-descent parser, check they agree, and report tokens/sec of both.
+//
+int main(int argc, char *argv[]) {
+    std::size_t tokenCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    auto gc = GrammarContextBuilder::buildFromFile(std::string(BENCH_GRAMMAR_FILE));
+    if (!gc) { return 1; }
+
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+
+    SentenceGenerator generator(gc);
+    std::vector<SymbolId> terminals;
+    std::vector<std::size_t> sentenceBegin{0};
+    terminals.reserve(tokenCount + 4096);
+    while (terminals.size() < tokenCount) {
+        generator.generate(terminals);
+        sentenceBegin.push_back(terminals.size());
+    }
+    auto sentenceCount = sentenceBegin.size() - 1;
+
+    LL1Engine engine(gc, theLL1Analyzer.ll1Table());
+    ExprParser parser;
+
+    // Both parsers must apply the same productions.
+    for (std::size_t i = 0; i < sentenceCount; ++i) {
+        auto data = terminals.data() + sentenceBegin[i];
+        auto size = sentenceBegin[i + 1] - sentenceBegin[i];
+        if (engine.parse(data, size) != LL1Engine::Status::accepted || !parser.parse(data, size)
+            || engine.productions() != parser.productions()) {
+            printf("error, the parsers disagree on sentence %zu.\n", i);
+            return 1;
+        }
+    }
+
+    auto measure = [&](const char *name, auto &&parse) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < sentenceCount; ++i) {
+            parse(terminals.data() + sentenceBegin[i], sentenceBegin[i + 1] - sentenceBegin[i]);
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        std::cout << name << " : " << seconds.count() << " seconds, "
+                  << static_cast<std::size_t>(terminals.size() / seconds.count()) << " tokens/sec\n";
+    };
+
+    std::cout << "tokens           : " << terminals.size() << "\n";
+    std::cout << "sentences        : " << sentenceCount << "\n";
+    measure("table-driven     ", [&](const SymbolId *data, std::size_t size) { engine.parse(data, size); });
+    measure("recursive-descent", [&](const SymbolId *data, std::size_t size) { parser.parse(data, size); });
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1Analyzer.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace csa;
+
+//
+// Usage: bench03_CompressedLL1Table [grammar-file] [lookup-count]
+//
+// Report the compression ratio of the LL(1) table, check the compressed table
+// matches the dense one, and compare random lookups/sec of both.
+//
+int main(int argc, char *argv[]) {
+    std::string filename = argc > 1 ? argv[1] : BENCH_GRAMMAR_FILE;
+    std::size_t lookupCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000000;
+    auto gc = GrammarContextBuilder::buildFromFile(filename);
+    if (!gc) { return 1; }
+
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+
+    auto &dense = theLL1Analyzer.ll1Table();
+    auto &compressed = theLL1Analyzer.compressedLL1Table();
+    compressed.dump();
+    if (dense.rowCount() == 0 || dense.columnCount() == 0) { return 0; }
+
+    for (std::size_t row = 0; row < dense.rowCount(); ++row) {
+        for (std::size_t column = 0; column < dense.columnCount(); ++column) {
+            if (compressed.at(row, column) != dense.at(row, column)) {
+                printf("error, the compressed table mismatch at row = %zu, column = %zu.\n", row, column);
+                return 1;
+            }
+        }
+    }
+
+    // Random cells, the same for both tables.
+    std::mt19937 random(1);
+    std::vector<std::pair<std::size_t, std::size_t>> cells(4096);
+    for (auto &cell : cells) {
+        cell = {random() % dense.rowCount(), random() % dense.columnCount()};
+    }
+
+    auto measure = [&](const char *name, auto &&at) {
+        std::size_t sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < lookupCount; ++i) {
+            auto &cell = cells[i % cells.size()];
+            sum += static_cast<std::size_t>(at(cell.first, cell.second));
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        std::cout << name << " : " << static_cast<std::size_t>(lookupCount / seconds.count())
+                  << " lookups/sec (checksum " << sum << ")\n";
+    };
+
+    measure("dense     ", [&](std::size_t row, std::size_t column) { return dense.at(row, column); });
+    measure("compressed", [&](std::size_t row, std::size_t column) { return compressed.at(row, column); });
+
+    return 0;
+}
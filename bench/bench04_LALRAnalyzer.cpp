@@ -0,0 +1,105 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LALRAnalyzer.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using namespace csa;
+
+// Write the grammar as a bison file, so "bison <file>" builds the same LALR(1) table.
+int writeBisonFile(GrammarContextPtr gc, const std::string &filename) {
+    std::ofstream ofs(filename);
+    if (!ofs) {
+        printf("error: cannot write file = %s\n", filename.c_str());
+        return 1;
+    }
+
+    auto nameOf = [](SymbolPtr symbol) { return (symbol->isTerminal() ? "T" : "N") + std::to_string(symbol->id()); };
+
+    ofs << "%token";
+    for (auto symbol : gc->st->table()) {
+        if (symbol->isTerminal() && !symbol->isTerminalEof() && !symbol->isTerminalEpsilon() &&
+            !symbol->isAlienSymbol()) {
+            ofs << " " << nameOf(symbol);
+        }
+    }
+    ofs << "\n%%\n";
+
+    // Bison adds its own start production.
+    auto &pl = gc->pl->table();
+    for (std::size_t i = pl.front().lhs.symbol->isStartSymbol() ? 1 : 0; i < pl.size(); ++i) {
+        auto &p = pl[i];
+        ofs << nameOf(p.lhs.symbol) << ":";
+        for (auto symbol : p.rhs.symbolList) {
+            if (symbol->isTerminalEpsilon()) {
+                ofs << " %empty";
+            } else if (!symbol->isTerminalEof()) {
+                ofs << " " << nameOf(symbol);
+            }
+        }
+        ofs << ";\n";
+    }
+
+    return 0;
+}
+
+//
+// Usage: bench04_LALRAnalyzer <grammar-file> [bison-file]
+//
+// Report the time to build the LALR(1) table, and the conflicts counted the way bison does.
+// With a bison file, the same grammar is written for "time bison <bison-file>".
+//
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("usage: bench04_LALRAnalyzer <grammar-file> [bison-file]\n");
+        return 1;
+    }
+
+    auto gc = GrammarContextBuilder::buildFromFile(std::string(argv[1]));
+    if (!gc) { return 1; }
+    if (argc > 2 && writeBisonFile(gc, argv[2]) != 0) { return 1; }
+
+    auto start = std::chrono::steady_clock::now();
+    LALRAnalyzer theLALRAnalyzer(gc);
+    if (theLALRAnalyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    // A cell with a shift and reductions is one shift/reduce conflict,
+    // every reduction more than one in a cell is one reduce/reduce conflict.
+    std::size_t shiftReduceCount = 0;
+    std::size_t reduceReduceCount = 0;
+    auto &table = theLALRAnalyzer.lrxTable();
+    for (auto &conflict : table.conflicts) {
+        std::size_t reduceCount = 0;
+        bool hasShift = false;
+        for (auto action : table.actionsOf(conflict)) {
+            if (action.type() == LRxTable::Action::Type::Reduce) { ++reduceCount; }
+            if (action.type() == LRxTable::Action::Type::Goto) { hasShift = true; }
+        }
+        if (hasShift && reduceCount > 0) { ++shiftReduceCount; }
+        if (reduceCount > 1) { reduceReduceCount += reduceCount - 1; }
+    }
+
+    auto &statistics = theLALRAnalyzer.statistics();
+    std::cout << "states                  : " << theLALRAnalyzer.stateFamily()->stateCount() << "\n";
+    std::cout << "nonterminal transitions : " << statistics.nonterminalTransitionCount << "\n";
+    std::cout << "reads/includes/lookback : " << statistics.readsCount << "/" << statistics.includesCount << "/"
+              << statistics.lookbackCount << "\n";
+    std::cout << "conflicts               : " << shiftReduceCount << " shift/reduce, " << reduceReduceCount
+              << " reduce/reduce\n";
+    std::cout << "seconds                 : " << seconds.count() << "\n";
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LR1Analyzer.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace csa;
+
+int run(const char *filename, LR1Analyzer::Merging merging, const char *name) {
+    auto gc = GrammarContextBuilder::buildFromFile(std::string(filename));
+    if (!gc) { return 1; }
+
+    auto start = std::chrono::steady_clock::now();
+    LR1Analyzer theLR1Analyzer(gc);
+    theLR1Analyzer.setMerging(merging);
+    if (theLR1Analyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    auto conflicts = theLR1Analyzer.lrxTable().conflicts.size();
+
+    auto &statistics = theLR1Analyzer.statistics();
+    printf("%-9s states = %zu, built = %zu, merges = %zu, expands = %zu, conflict cells = %zu, time = %.3fs\n",
+           name, theLR1Analyzer.stateFamily()->stateCount(), statistics.builtStateCount, statistics.mergeCount,
+           statistics.expandCount, conflicts, seconds.count());
+    return 0;
+}
+
+//
+// Usage: bench05_LR1Analyzer <grammar-file> [--pager-only]
+//
+// Report the state counts of canonical LR(1) and Pager's merging on the same grammar.
+// Canonical LR(1) may be huge on a big grammar, so it can be skipped.
+//
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("usage: bench05_LR1Analyzer <grammar-file> [--pager-only]\n");
+        return 1;
+    }
+
+    if (run(argv[1], LR1Analyzer::Merging::pager, "pager") != 0) { return 1; }
+    if (argc > 2 && std::strcmp(argv[2], "--pager-only") == 0) { return 0; }
+    return run(argv[1], LR1Analyzer::Merging::canonical, "canonical");
+}
@@ -0,0 +1,99 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LR0Analyzer.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+using namespace csa;
+
+// Are the states, their transitions and reductions all the same.
+bool isSame(const LRxStateFamily &sf, const LRxStateFamily &other) {
+    if (sf.stateCount() != other.stateCount()) { return false; }
+    for (std::size_t id = 0; id < sf.stateCount(); ++id) {
+        auto state = sf.getState(id);
+        auto otherState = other.getState(id);
+        if (state->kernel != otherState->kernel || state->reductions != otherState->reductions ||
+            state->transitions.size() != otherState->transitions.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < state->transitions.size(); ++i) {
+            if (state->transitions[i].first != otherState->transitions[i].first ||
+                state->transitions[i].second->id != otherState->transitions[i].second->id) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//
+// Usage: bench06_ParallelStateFamily <grammar-file> [max-jobs]
+//
+// Build the LR(0) states with 1, 2, 4 ... max-jobs threads, report the speedup over the serial build,
+// and check every parallel build gives the same states. Then run a chain of tasks, every task pushes
+// the next one, so only one worker is busy at a time: the cpu time over the wall time shows how much
+// the idle workers burn, it is about 1 when they sleep.
+//
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("usage: bench06_ParallelStateFamily <grammar-file> [max-jobs]\n");
+        return 1;
+    }
+
+    auto gc = GrammarContextBuilder::buildFromFile(std::string(argv[1]));
+    if (!gc) { return 1; }
+    std::size_t maxJobs = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    auto build = [&](std::size_t jobs, double &seconds) {
+        auto start = std::chrono::steady_clock::now();
+        auto sf = LR0Analyzer::buildStateFamily(gc, jobs);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return sf;
+    };
+
+    double serialSeconds;
+    auto serial = build(1, serialSeconds);
+    printf("states = %zu, hardware threads = %u\n", serial->stateCount(), std::thread::hardware_concurrency());
+    printf("jobs = %-3d time = %.3fs\n", 1, serialSeconds);
+
+    for (std::size_t jobs = 2; jobs <= maxJobs; jobs *= 2) {
+        double seconds;
+        auto sf = build(jobs, seconds);
+        if (!isSame(*serial, *sf)) {
+            printf("error, the states of %zu jobs differ from the serial build.\n", jobs);
+            return 1;
+        }
+        printf("jobs = %-3zu time = %.3fs, speedup = %.2f\n", jobs, seconds, serialSeconds / seconds);
+    }
+
+    for (std::size_t jobs = 2; jobs <= maxJobs; jobs *= 2) {
+        WorkStealingPool<std::size_t> pool(jobs);
+        std::atomic<std::size_t> sum{0};
+        pool.push(0, 0);
+        auto start = std::chrono::steady_clock::now();
+        auto cpuStart = std::clock();
+        pool.run([&](std::size_t task, std::size_t worker) {
+            std::size_t value = task;
+            for (std::size_t i = 0; i < 20000; ++i) { value = value * 31 + i; }
+            sum += value;
+            if (task < 2000) { pool.push(worker, task + 1); }
+        });
+        auto cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("jobs = %-3zu serial chain time = %.3fs, cpu time = %.3fs, cpu / time = %.2f, checksum = %zu\n", jobs,
+               seconds, cpuSeconds, cpuSeconds / seconds, sum.load());
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1Analyzer.h"
+#include <chrono>
+#include <iostream>
+
+using namespace csa;
+
+// Write the productions as a grammar in the same order, so a new parse gives the same ids.
+// The start production is left out, the parser adds it again.
+std::string grammarOf(GrammarContextPtr gc) {
+    auto nameOf = [](SymbolPtr symbol) {
+        std::string name(symbol->name());
+        if (name.find_first_of("|\"\\ \t") == std::string::npos) { return name; }
+        std::string quoted("\"");
+        for (auto c : name) {
+            if (c == '"' || c == '\\') { quoted += '\\'; }
+            quoted += c;
+        }
+        return quoted + "\"";
+    };
+
+    std::string stream;
+    auto &pl = gc->pl->table();
+    for (std::size_t i = pl.front().lhs.symbol->isStartSymbol() ? 1 : 0; i < pl.size(); ++i) {
+        stream += nameOf(pl[i].lhs.symbol) + " ->";
+        for (auto symbol : pl[i].rhs.symbolList) { stream += " " + nameOf(symbol); }
+        stream += "\n";
+    }
+    return stream;
+}
+
+//
+// Usage: bench07_IncrementalLL1 <grammar-file> [edits]
+//
+// Edit the analyzed grammar one production at a time: remove a production, then add it back.
+// Only the productions whose left hand side has another production are edited, the last
+// production of a used nonterminal can't be removed.
+// Report the average time of an incremental edit against a full analysis, and check the
+// LL(1) table after all the edits is the same as a full analysis of the edited grammar.
+//
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("usage: bench07_IncrementalLL1 <grammar-file> [edits]\n");
+        return 1;
+    }
+
+    auto gc = GrammarContextBuilder::buildFromFile(std::string(argv[1]));
+    if (!gc) { return 1; }
+    std::size_t edits = argc > 2 ? std::max(1ul, std::stoul(argv[2])) : 100;
+
+    auto start = std::chrono::steady_clock::now();
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+    std::chrono::duration<double> fullSeconds = std::chrono::steady_clock::now() - start;
+
+    // Productions are picked over the whole grammar, the first two are kept so the start symbol stays.
+    // An edit moves a production to the end, so the count of productions of every symbol stays.
+    auto productionCount = gc->pl->table().size();
+    std::vector<std::size_t> countOfLhs(gc->st->symbolCount());
+    for (auto &p : gc->pl->table()) { ++countOfLhs[p.lhs.symbol->id()]; }
+    auto isEditable = [&](std::size_t id) { return countOfLhs[gc->pl->table()[id].lhs.symbol->id()] > 1; };
+    std::size_t editableCount = 0;
+    for (std::size_t id = 2; id < productionCount; ++id) { editableCount += isEditable(id) ? 1 : 0; }
+    if (editableCount == 0) {
+        printf("error, the grammar has no production to edit.\n");
+        return 1;
+    }
+    std::chrono::duration<double> removeSeconds(0), addSeconds(0);
+    for (std::size_t i = 0; i < edits; ++i) {
+        auto id = 2 + i * 7919 % (productionCount - 2);
+        while (!isEditable(id)) { id = id + 1 < productionCount ? id + 1 : 2; }
+        auto &p = gc->pl->table()[id];
+        std::string lhs(p.lhs.symbol->name());
+        std::vector<std::string_view> rhs;
+        for (auto symbol : p.rhs.symbolList) { rhs.push_back(symbol->name()); }
+
+        start = std::chrono::steady_clock::now();
+        if (theLL1Analyzer.removeProduction(static_cast<int>(id)) != 0) { return 1; }
+        auto middle = std::chrono::steady_clock::now();
+        if (theLL1Analyzer.addProduction(lhs, rhs) < 0) { return 1; }
+        removeSeconds += middle - start;
+        addSeconds += std::chrono::steady_clock::now() - middle;
+    }
+
+    auto other = GrammarContextBuilder::buildFromStream(grammarOf(gc));
+    LL1Analyzer otherLL1Analyzer(other);
+    if (!other || otherLL1Analyzer.parse() != 0 ||
+        otherLL1Analyzer.ll1Table().cells != theLL1Analyzer.ll1Table().cells ||
+        otherLL1Analyzer.ll1Table().conflicts != theLL1Analyzer.ll1Table().conflicts) {
+        printf("error, the incremental analysis differs from the full analysis.\n");
+        return 1;
+    }
+
+    printf("productions = %zu, edits = %zu\n", productionCount, edits);
+    printf("full analysis       time = %.3fms\n", fullSeconds.count() * 1000);
+    printf("remove a production time = %.3fms\n", removeSeconds.count() * 1000 / edits);
+    printf("add a production    time = %.3fms\n", addSeconds.count() * 1000 / edits);
+    printf("incremental visits = %zu\n", theLL1Analyzer.statistics().incrementalVisitCount);
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "GrammarImage.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+using namespace csa;
+namespace fs = std::filesystem;
+
+//
+// Usage: bench08_GrammarImage <grammar-file> [rounds]
+//
+// Write the image of an analyzed grammar, then compare the time to get the analysis from
+// the grammar file(scan, parse and analyze), from the mapped image(open and look up every
+// cell), and from the image into a grammar context and an analyzer(build and load).
+//
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("usage: bench08_GrammarImage <grammar-file> [rounds]\n");
+        return 1;
+    }
+
+    std::string filename(argv[1]);
+    std::size_t rounds = argc > 2 ? std::max(1ul, std::stoul(argv[2])) : 10;
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    auto gc = GrammarContextBuilder::buildFromFile(filename);
+    LL1Analyzer theLL1Analyzer(gc);
+    if (!gc || theLL1Analyzer.parse() != 0) {
+        printf("error, cannot analyze the grammar.\n");
+        return 1;
+    }
+    std::chrono::duration<double> parseSeconds = Clock::now() - start;
+
+    auto imageFilename = (fs::temp_directory_path() / "bench08_GrammarImage.img").string();
+    start = Clock::now();
+    if (GrammarImage::writeToFile(theLL1Analyzer, imageFilename) != 0) {
+        printf("error, cannot write the image.\n");
+        return 1;
+    }
+    std::chrono::duration<double> writeSeconds = Clock::now() - start;
+
+    std::chrono::duration<double> openSeconds(0), lookupSeconds(0), loadSeconds(0);
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < rounds; ++i) {
+        start = Clock::now();
+        GrammarImage image;
+        if (image.open(imageFilename) != 0) {
+            printf("error, cannot open the image.\n");
+            return 1;
+        }
+        auto middle = Clock::now();
+        for (std::size_t row = 0; row < image.rowCount(); ++row) {
+            for (std::size_t column = 0; column < image.columnCount(); ++column) {
+                sum += static_cast<std::size_t>(image.cellAt(row, column) + 2);
+            }
+        }
+        openSeconds += middle - start;
+        lookupSeconds += Clock::now() - middle;
+
+        start = Clock::now();
+        auto imageGc = GrammarContextBuilder::buildFromImage(image);
+        LL1Analyzer imageLL1Analyzer(imageGc);
+        if (!imageGc || imageLL1Analyzer.loadAnalysis(image) != 0 ||
+            imageLL1Analyzer.ll1Table().cells != theLL1Analyzer.ll1Table().cells ||
+            imageLL1Analyzer.ll1Table().conflicts != theLL1Analyzer.ll1Table().conflicts) {
+            printf("error, the image differs from the analysis.\n");
+            return 1;
+        }
+        loadSeconds += Clock::now() - start;
+    }
+
+    auto &table = theLL1Analyzer.ll1Table();
+    printf("productions = %zu, symbols = %zu, cells = %zu, image bytes = %ju, checksum = %zu\n",
+           gc->pl->table().size(), gc->st->symbolCount(), table.cells.size(),
+           static_cast<std::uintmax_t>(fs::file_size(imageFilename)), sum);
+    printf("parse and analyze        time = %.3fms\n", parseSeconds.count() * 1000);
+    printf("write image              time = %.3fms\n", writeSeconds.count() * 1000);
+    printf("open image               time = %.3fms\n", openSeconds.count() * 1000 / rounds);
+    printf("look up all the cells    time = %.3fms\n", lookupSeconds.count() * 1000 / rounds);
+    printf("build and load analyzer  time = %.3fms\n", loadSeconds.count() * 1000 / rounds);
+
+    fs::remove(imageFilename);
+    return 0;
+}
@@ -9,13 +9,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <bitset>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
 #include <list>
 #include <map>
 #include <memory>
+#include <new>
 #include <set>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace csa {
@@ -35,14 +44,171 @@ auto constexpr alien = "<- alien ->";    ///< An impossible token doesn't belong
 
 class Symbol;
 using SymbolPtr = Symbol *;
-using SymbolSet = std::set<SymbolPtr>;
+using SymbolId = std::size_t;
 using SymbolList = std::vector<SymbolPtr>;
 
+/**
+ * @brief A set of symbols backed by a word-packed bitset.
+ *
+ * Every symbol owns a dense id given by the symbol table, and the id is the bit index,
+ * so union and intersection are word-wise operations and iteration follows id order.
+ * Iteration yields symbol ids, use SymbolTable::getSymbol() to get the symbol back.
+ */
+class SymbolSet {
+public:
+    using Word = std::uint64_t;
+    static constexpr std::size_t wordBits = 64;
+    static constexpr SymbolId npos = static_cast<SymbolId>(-1);
+
+    class Iterator {
+    public:
+        Iterator(const SymbolSet *set, SymbolId id) : set_(set), id_(id) {}
+        SymbolId operator*() const { return id_; }
+        Iterator &operator++() {
+            id_ = set_->next(id_ + 1);
+            return *this;
+        }
+        bool operator==(const Iterator &other) const { return id_ == other.id_; }
+        bool operator!=(const Iterator &other) const { return id_ != other.id_; }
+
+    private:
+        const SymbolSet *set_;
+        SymbolId id_;
+    };
+
+    Iterator begin() const { return Iterator(this, next(0)); }
+    Iterator end() const { return Iterator(this, npos); }
+
+    /**
+     * @brief Insert a symbol id.
+     *
+     * @return true     The id is new to this set.
+     * @return false    The id already exists.
+     */
+    bool insert(SymbolId id) {
+        auto index = id / wordBits;
+        if (index >= words_.size()) { words_.resize(index + 1, 0); }
+        auto mask = Word(1) << (id % wordBits);
+        if (words_[index] & mask) { return false; }
+        words_[index] |= mask;
+        return true;
+    }
+
+    /**
+     * @brief Erase a symbol id.
+     *
+     * @return true     The id is found and erased.
+     * @return false    The id is not found.
+     */
+    bool erase(SymbolId id) {
+        if (!contains(id)) { return false; }
+        words_[id / wordBits] &= ~(Word(1) << (id % wordBits));
+        return true;
+    }
+
+    bool contains(SymbolId id) const {
+        auto index = id / wordBits;
+        return index < words_.size() && (words_[index] >> (id % wordBits)) & 1;
+    }
+
+    /**
+     * @brief Merge other set into this set.
+     *
+     * @return true     This set has changed.
+     * @return false    This set has no change.
+     */
+    bool unite(const SymbolSet &other) {
+        if (words_.size() < other.words_.size()) { words_.resize(other.words_.size(), 0); }
+        Word changed = 0;
+        for (std::size_t i = 0; i < other.words_.size(); ++i) {
+            auto old = words_[i];
+            words_[i] |= other.words_[i];
+            changed |= words_[i] ^ old;
+        }
+        return changed != 0;
+    }
+
+    bool intersects(const SymbolSet &other) const {
+        auto size = std::min(words_.size(), other.words_.size());
+        for (std::size_t i = 0; i < size; ++i) {
+            if (words_[i] & other.words_[i]) { return true; }
+        }
+        return false;
+    }
+
+    std::size_t size() const {
+        std::size_t count = 0;
+        for (auto word : words_) { count += std::bitset<wordBits>(word).count(); }
+        return count;
+    }
+
+    bool empty() const {
+        for (auto word : words_) {
+            if (word) { return false; }
+        }
+        return true;
+    }
+
+    void clear() { words_.clear(); }
+
+    /**
+     * @brief Get the packed words, bit i of word w is the symbol id w * wordBits + i.
+     */
+    const std::vector<Word> &words() const { return words_; }
+    void setWords(std::vector<Word> words) { words_ = std::move(words); }
+
+    bool operator==(const SymbolSet &other) const {
+        auto size = std::max(words_.size(), other.words_.size());
+        for (std::size_t i = 0; i < size; ++i) {
+            if (wordAt(i) != other.wordAt(i)) { return false; }
+        }
+        return true;
+    }
+    bool operator!=(const SymbolSet &other) const { return !(*this == other); }
+
+private:
+    Word wordAt(std::size_t index) const { return index < words_.size() ? words_[index] : 0; }
+
+    /**
+     * @brief Find the first id which is not less than the input id.
+     *
+     * @return SymbolId     The found id, or npos if not found.
+     */
+    SymbolId next(SymbolId id) const {
+        auto index = id / wordBits;
+        if (index >= words_.size()) { return npos; }
+        auto word = words_[index] & (~Word(0) << (id % wordBits));
+        while (true) {
+            if (word) { return index * wordBits + countTrailingZeros(word); }
+            if (++index >= words_.size()) { return npos; }
+            word = words_[index];
+        }
+    }
+
+    static std::size_t countTrailingZeros(Word word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+        std::size_t count = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    std::vector<Word> words_;
+};
+
 /**
  * @brief Symbol definition.
  *
  * A symbol(aka token) is terminal or nonterminal.
+ * Its name and hot flags(type, nillable) are stored by the symbol table which owns it.
  */
+class SymbolTable;
+
 class Symbol {
 public:
     enum class Type : int {
@@ -62,35 +228,54 @@ public:
      * 3, At parser, if the symbol is production's left hand symbol, it is nonterminal,
      *    and all other symbols(type is unkown) will be terminal.
      *
-     * @param[in] name  Input symbol name.
-     */
-    Symbol(std::string name) : name_(name), type_(Type::unknown), isNillable_(false) {}
-    std::string name() { return name_; }
-    void setNillable(bool value) { isNillable_ = value; }
-    bool isNillable() { return isNillable_; }
-    bool isTerminal() { return static_cast<int>(type_) > static_cast<int>(Type::nonterminal); }
-    bool isTerminalEof() { return type_ == Type::terminalIsEof; }
-    bool isTerminalEpsilon() { return type_ == Type::terminalIsEpsilon; }
-    bool isNonterminal() { return !isTerminal(); }
-    bool isStartSymbol(){ return this->name() == config::keyword::start; }
-    bool isAlienSymbol(){ return this->name() == config::keyword::alien; }
-    void setType(Type type) { type_ = type; }
-    Type getType() { return type_; }
+     * @param[in] table Input symbol table which owns this symbol.
+     * @param[in] id    Input dense symbol id, it is given by the symbol table.
+     * @param[in] name  Input symbol name, it is stored by the symbol table.
+     */
+    Symbol(SymbolTable *table, SymbolId id, std::string_view name)
+        : table_(table), id_(id), name_(name) {}
+    Symbol(const Symbol &) = delete;
+    Symbol &operator=(const Symbol &) = delete;
+
+    /**
+     * @brief Get the symbol name.
+     *
+     * It is a view to the symbol table's name storage, and it is null-terminated.
+     */
+    std::string_view name() const { return name_; }
+    SymbolId id() const { return id_; }
+    void setNillable(bool value);
+    bool isNillable() const;
+    bool isTerminal() const { return static_cast<int>(getType()) > static_cast<int>(Type::nonterminal); }
+    bool isTerminalEof() const { return getType() == Type::terminalIsEof; }
+    bool isTerminalEpsilon() const { return getType() == Type::terminalIsEpsilon; }
+    bool isNonterminal() const { return !isTerminal(); }
+    bool isStartSymbol() const { return this->name() == config::keyword::start; }
+    bool isAlienSymbol() const { return this->name() == config::keyword::alien; }
+    void setType(Type type);
+    Type getType() const;
     SymbolSet &firstSet() { return std::ref(firstSet_); }
     SymbolSet &followSet() { return std::ref(followSet_); }
 
 private:
-    std::string name_;       ///< Symbol name.
-    Type type_;              ///< Symbol type.
-    bool isNillable_;        ///< Only used by nonterminal.
-    SymbolSet firstSet_;     ///< First set of this symbol.
-    SymbolSet followSet_;    ///< Follow set of this symbol.
+    SymbolTable *table_;      ///< The symbol table which owns this symbol.
+    SymbolId id_;             ///< Dense symbol id, it is the bit index in a SymbolSet.
+    std::string_view name_;   ///< Symbol name.
+    SymbolSet firstSet_;      ///< First set of this symbol.
+    SymbolSet followSet_;     ///< Follow set of this symbol.
 };
 
 /**
  * @brief A symbol table manage all symbol's life time.
  *
  * All the symbols are singleton, so no duplicated symbol exist.
+ * Every symbol is given a dense id in creation order, starting from the alien symbol.
+ *
+ * It is an interner, all the memory is taken from a few big blocks:
+ * - symbols are placed in fixed size arena blocks, so they never move;
+ * - names are stored contiguously in name blocks, and looked up by an open addressing
+ *   hash index of string views, so finding an existing symbol allocates nothing;
+ * - hot flags(type, nillable) are packed in a side array indexed by symbol id.
  */
 class SymbolTable;
 using SymbolTablePtr = std::shared_ptr<SymbolTable>;
@@ -98,14 +283,17 @@ using SymbolTablePtr = std::shared_ptr<SymbolTable>;
 class SymbolTable {
 public:
     SymbolTable() {
-        alien_ = new Symbol(config::keyword::alien);
+        index_.assign(initialIndexSize, npos);
+        alien_ = createSymbol(config::keyword::alien);
         alien_->setType(Symbol::Type::terminal);
-        alien_->firstSet().insert(alien_);
+        alien_->firstSet().insert(alien_->id());
     }
     ~SymbolTable() {
-        for (auto &item : table_) { delete item.second; }
-        if(alien_) { delete alien_; }
+        for (auto symbol : symbolList_) { symbol->~Symbol(); }
+        for (auto block : symbolBlocks_) { ::operator delete(block); }
     }
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
 
     /**
      * @brief Get the Alien Symbol which doesn't belong to any grammar.
@@ -126,31 +314,69 @@ public:
      * @param[in] name      Input symbol name.
      * @return SymbolPtr    A symbol instance.
      */
-    SymbolPtr findSymbol(std::string name) {
+    SymbolPtr findSymbol(std::string_view name) {
         assert(!name.empty());
 
-        auto &symbol = table_[name];
-        if (!symbol) {
-            symbol = new Symbol(name);
-            assert(symbol);
-        }
+        auto slot = findSlot(name);
+        if (index_[slot] != npos) { return symbolList_[index_[slot]]; }
+
+        auto symbol = createSymbol(name);
+        assert(symbol);
+        index_[slot] = symbol->id();
+        if (++indexCount_ * 2 > index_.size()) { rehash(index_.size() * 2); }
 
         return symbol;
     }
 
-    const std::map<std::string, SymbolPtr> &table() const { return std::ref(table_); }
+    /**
+     * @brief Get symbol by its dense id.
+     *
+     * @param[in] id        Input symbol id, it must be less than symbolCount().
+     * @return SymbolPtr    A symbol instance.
+     */
+    SymbolPtr getSymbol(SymbolId id) const {
+        assert(id < symbolList_.size());
+        return symbolList_[id];
+    }
+
+    /**
+     * @brief Get the count of all the symbols(include the alien symbol).
+     */
+    std::size_t symbolCount() const { return symbolList_.size(); }
+
+    /**
+     * @brief Get all the symbols(include the alien symbol) sorted by id.
+     */
+    const SymbolList &table() const { return std::ref(symbolList_); }
+
+    Symbol::Type getType(SymbolId id) const {
+        return static_cast<Symbol::Type>(flags_[id] & typeMask);
+    }
+    void setType(SymbolId id, Symbol::Type type) {
+        flags_[id] = (flags_[id] & ~typeMask) | static_cast<std::uint8_t>(type);
+    }
+    bool isNillable(SymbolId id) const { return flags_[id] & nillableFlag; }
+    void setNillable(SymbolId id, bool value) {
+        flags_[id] = value ? (flags_[id] | nillableFlag) : (flags_[id] & ~nillableFlag);
+    }
 
     void dump() {
+        SymbolList symbolList;
         std::size_t max = 0;
-        for (auto &item : table_) {
-            auto size = item.first.size();
+        for (auto &symbol : symbolList_) {
+            if (symbol == alien_) { continue; }
+            symbolList.push_back(symbol);
+            auto size = symbol->name().size();
             if (max < size) { max = size; }
         }
+        std::sort(symbolList.begin(), symbolList.end(), [](SymbolPtr a, SymbolPtr b) {
+            return a->name() < b->name();
+        });
         printf("[dump-symboltable-begin]\n");
-        for (auto &item : table_) {
-            printf("  name = %-*s", max, item.first.c_str());
+        for (auto &symbol : symbolList) {
+            printf("  name = %-*s", static_cast<int>(max), symbol->name().data());
             printf("  type = ");
-            switch (item.second->getType()) {
+            switch (symbol->getType()) {
                 case Symbol::Type::unknown:
                     printf("unknown");
                     break;
@@ -175,20 +401,104 @@ public:
     }
 
 private:
-    std::map<std::string, SymbolPtr> table_;
+    static constexpr SymbolId npos = static_cast<SymbolId>(-1);
+    static constexpr std::size_t initialIndexSize = 64;      ///< Must be power of 2.
+    static constexpr std::size_t symbolBlockSize = 1024;     ///< Symbols per arena block.
+    static constexpr std::size_t nameBlockSize = 64 * 1024;  ///< Bytes per name block.
+    static constexpr std::uint8_t typeMask = 0x07;
+    static constexpr std::uint8_t nillableFlag = 0x08;
+
+    /**
+     * @brief Find the index slot of the name, it is an empty slot if the name is not found.
+     */
+    std::size_t findSlot(std::string_view name) const {
+        auto mask = index_.size() - 1;
+        auto slot = std::hash<std::string_view>{}(name) & mask;
+        while (index_[slot] != npos && symbolList_[index_[slot]]->name() != name) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(std::size_t size) {
+        index_.assign(size, npos);
+        for (auto &symbol : symbolList_) {
+            if (symbol == alien_) { continue; }
+            index_[findSlot(symbol->name())] = symbol->id();
+        }
+    }
+
+    /**
+     * @brief Copy the name into the name blocks, and append a null-terminator.
+     */
+    std::string_view storeName(std::string_view name) {
+        auto size = name.size() + 1;
+        char *data;
+        if (size > nameBlockSize) {
+            // A huge name takes a block of its own.
+            nameBlocks_.emplace_back(new char[size]);
+            data = nameBlocks_.back().get();
+        } else {
+            if (nameBlockUsed_ + size > nameBlockSize) {
+                nameBlocks_.emplace_back(new char[nameBlockSize]);
+                nameBlock_ = nameBlocks_.back().get();
+                nameBlockUsed_ = 0;
+            }
+            data = nameBlock_ + nameBlockUsed_;
+            nameBlockUsed_ += size;
+        }
+        std::memcpy(data, name.data(), name.size());
+        data[name.size()] = '\0';
+        return {data, name.size()};
+    }
+
+    SymbolPtr createSymbol(std::string_view name) {
+        auto id = symbolList_.size();
+        if (id % symbolBlockSize == 0) {
+            symbolBlocks_.push_back(static_cast<SymbolPtr>(::operator new(sizeof(Symbol) * symbolBlockSize)));
+        }
+        auto symbol = new (symbolBlocks_.back() + id % symbolBlockSize) Symbol(this, id, storeName(name));
+        symbolList_.push_back(symbol);
+        flags_.push_back(static_cast<std::uint8_t>(Symbol::Type::unknown));
+        return symbol;
+    }
+
+    std::vector<SymbolPtr> symbolBlocks_;              ///< Arena blocks of symbols.
+    std::vector<std::unique_ptr<char[]>> nameBlocks_;  ///< Name storage.
+    char *nameBlock_ = nullptr;                        ///< The name block being filled.
+    std::size_t nameBlockUsed_ = nameBlockSize;        ///< Used bytes of the name block being filled.
+    std::vector<SymbolId> index_;                      ///< Open addressing hash index of names.
+    std::size_t indexCount_ = 0;                       ///< Count of the symbols in the index.
+    SymbolList symbolList_;                            ///< Symbol id mapping symbol.
+    std::vector<std::uint8_t> flags_;                  ///< Symbol id mapping hot flags.
     SymbolPtr alien_;
 };
 
+inline void Symbol::setNillable(bool value) { table_->setNillable(id_, value); }
+inline bool Symbol::isNillable() const { return table_->isNillable(id_); }
+inline void Symbol::setType(Type type) { table_->setType(id_, type); }
+inline Symbol::Type Symbol::getType() const { return table_->getType(id_); }
+
 struct Production {
     struct LeftHandSide {
         Symbol *symbol = nullptr;    ///< A symbol reference from symbol table.
     };
 
     struct RightHandSide {
+        /**
+         * @brief A suffix of the right-hand-side, begins at some symbol and ends at the end.
+         */
+        struct Suffix {
+            SymbolSet firstSet;        ///< First set of the suffix.
+            bool isNillable = true;    ///< Is every symbol of the suffix nillable.
+        };
+
         SymbolList symbolList;              ///< All the symbols are reference from symbol table.
         mutable SymbolSet firstSet;         ///< First set of right-hand-side.
         mutable SymbolSet predictSet;       ///< Predict set of right-hand-side.
         mutable bool isNillable = false;    ///< Is right-hand-side nillable.
+        /// suffixList[i] is the suffix begins at symbolList[i], the last one is the empty suffix.
+        mutable std::vector<Suffix> suffixList;
     };
 
     int id = -1;        ///< Production id.
@@ -219,19 +529,40 @@ using ProductionTablePtr = std::shared_ptr<ProductionTable>;
  */
 class ProductionTable {
 public:
-    ProductionTable(ProductionList &pl) : pl_(std::move(pl)) {}
+    ProductionTable(ProductionList &pl) : pl_(std::move(pl)) {
+        for (auto &p : pl_) { maxWidthOfNt_ = std::max(maxWidthOfNt_, p.lhs.symbol->name().size()); }
+    }
     const ProductionList &table() const { return std::ref(pl_); }
     bool empty() { return pl_.empty(); }
     int size() { return pl_.size(); }
-    std::size_t getMaxWidthOfNt() {
-        static std::size_t max = 0;
-        if (max == 0) {
-            for (auto &p : pl_) {
-                auto size = p.lhs.symbol->name().size();
-                if (max < size) { max = size; }
-            }
+    std::size_t getMaxWidthOfNt() const { return maxWidthOfNt_; }
+
+    /**
+     * @brief Insert a production at an id, the productions from it take the id one more.
+     *
+     * The productions may move, so references to them are invalid after it.
+     */
+    const Production &insert(std::size_t id, Production p) {
+        assert(id <= pl_.size());
+        for (auto i = id; i < pl_.size(); ++i) { ++pl_[i].id; }
+        p.id = static_cast<int>(id);
+        maxWidthOfNt_ = std::max(maxWidthOfNt_, p.lhs.symbol->name().size());
+        return *pl_.insert(pl_.begin() + static_cast<std::ptrdiff_t>(id), std::move(p));
+    }
+
+    /**
+     * @brief Erase a production, the productions after it take the id one less.
+     *
+     * The productions may move, so references to them are invalid after it.
+     */
+    void erase(std::size_t id) {
+        assert(id < pl_.size());
+        pl_.erase(pl_.begin() + static_cast<std::ptrdiff_t>(id));
+        maxWidthOfNt_ = 0;
+        for (auto &p : pl_) {
+            if (p.id > static_cast<int>(id)) { --p.id; }
+            maxWidthOfNt_ = std::max(maxWidthOfNt_, p.lhs.symbol->name().size());
         }
-        return max;
     }
     void dump() {
         std::cout << "[dump-production-table-begin]\n";
@@ -259,6 +590,7 @@ public:
 
 private:
     ProductionList pl_;
+    std::size_t maxWidthOfNt_ = 0;    ///< The longest name of the left hand sides.
 };
 
 /**
@@ -277,13 +609,276 @@ struct GrammarContext {
 };
 using GrammarContextPtr = std::shared_ptr<GrammarContext>;
 
+/**
+ * @brief A dense LL(1) parse table.
+ *
+ * It is a data object produced by LL1Analyzer, and consumed by parse engines, exporters and html.
+ * Rows are nonterminals in the order of their first production, columns are terminals in the
+ * order they first appear at right hand sides(the eof terminal takes the last column).
+ * Every cell is a production id, or emptyCell, or conflictCell which means more than one
+ * production predicts the cell and their ids are stored in the conflicts side list.
+ */
+struct LL1Table {
+    using Cell = std::int32_t;
+    static constexpr Cell emptyCell = -1;
+    static constexpr Cell conflictCell = -2;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    SymbolList nonterminals;                           ///< Row index mapping nonterminal.
+    SymbolList terminals;                              ///< Column index mapping terminal.
+    std::vector<std::size_t> rowOfSymbol;              ///< Symbol id mapping row index or npos.
+    std::vector<std::size_t> columnOfSymbol;           ///< Symbol id mapping column index or npos.
+    std::vector<Cell> cells;                           ///< All the cells in row major order.
+    std::map<std::size_t, std::vector<int>> conflicts; ///< Cell index mapping production ids.
+
+    std::size_t rowCount() const { return nonterminals.size(); }
+    std::size_t columnCount() const { return terminals.size(); }
+    std::size_t cellIndex(std::size_t row, std::size_t column) const { return row * terminals.size() + column; }
+    Cell at(std::size_t row, std::size_t column) const { return cells[cellIndex(row, column)]; }
+
+    /**
+     * @brief Find the cell of a nonterminal and a terminal.
+     *
+     * @return Cell     The cell, or emptyCell if any of the symbols is not in the table.
+     */
+    Cell find(SymbolPtr nonterminal, SymbolPtr terminal) const {
+        auto row = indexOf(rowOfSymbol, nonterminal);
+        auto column = indexOf(columnOfSymbol, terminal);
+        if (row == npos || column == npos) { return emptyCell; }
+        return at(row, column);
+    }
+
+    /**
+     * @brief Get all the production ids of a cell, they are sorted.
+     */
+    std::vector<int> productionsAt(std::size_t row, std::size_t column) const {
+        auto cell = at(row, column);
+        if (cell == conflictCell) { return conflicts.at(cellIndex(row, column)); }
+        if (cell == emptyCell) { return {}; }
+        return {cell};
+    }
+
+    bool hasConflict() const { return !conflicts.empty(); }
+
+    void clear() {
+        nonterminals.clear();
+        terminals.clear();
+        rowOfSymbol.clear();
+        columnOfSymbol.clear();
+        cells.clear();
+        conflicts.clear();
+    }
+
+private:
+    static std::size_t indexOf(const std::vector<std::size_t> &indexes, SymbolPtr symbol) {
+        return symbol && symbol->id() < indexes.size() ? indexes[symbol->id()] : npos;
+    }
+};
+
+/**
+ * @brief A LL(1) table compressed by row displacement(comb vector).
+ *
+ * Every row keeps a default cell, which is emptyCell unless one cell covers most of the row.
+ * The other cells of a row are packed into the shared entry vector at the row's displacement,
+ * and the check vector records the owner row of every entry, so a lookup is O(1):
+ *
+ *     index = base[row] + column
+ *     cell  = check[index] == row ? entries[index] : defaults[row]
+ *
+ * A lookup gives exactly the cell of the dense table, conflicts are still found in LL1Table.
+ */
+struct CompressedLL1Table {
+    using Cell = LL1Table::Cell;
+    using Index = std::int32_t;
+    static constexpr Index noRow = -1;
+
+    std::size_t rowCount = 0;
+    std::size_t columnCount = 0;
+    std::vector<Index> base;        ///< Row index mapping its displacement.
+    std::vector<Cell> defaults;     ///< Row index mapping its default cell.
+    std::vector<Cell> entries;      ///< Packed cells of all the rows.
+    std::vector<Index> check;       ///< Entry index mapping its owner row, or noRow.
+
+    Cell at(std::size_t row, std::size_t column) const {
+        auto index = static_cast<std::size_t>(base[row]) + column;
+        return index < check.size() && check[index] == static_cast<Index>(row) ? entries[index] : defaults[row];
+    }
+
+    std::size_t denseByteSize() const { return rowCount * columnCount * sizeof(Cell); }
+    std::size_t byteSize() const {
+        return (base.size() + check.size()) * sizeof(Index) + (defaults.size() + entries.size()) * sizeof(Cell);
+    }
+    double compressionRatio() const { return byteSize() ? static_cast<double>(denseByteSize()) / byteSize() : 1.0; }
+
+    /**
+     * @brief Compress a dense LL(1) table of a production list.
+     *
+     * The non-empty cells of a row are found by the predict sets of its productions, so the
+     * dense rows are not scanned. Rows with more packed cells are placed first, each at the
+     * lowest displacement where all its cells hit free entries(first fit).
+     */
+    void build(const LL1Table &table, const ProductionList &pl) {
+        clear();
+        rowCount = table.rowCount();
+        columnCount = table.columnCount();
+        base.assign(rowCount, 0);
+        defaults.assign(rowCount, LL1Table::emptyCell);
+
+        // Pick the default of every row, and collect the columns which differ from it.
+        auto productionsOfRow = groupByRow(table, pl);
+        std::vector<std::size_t> marks;
+        std::vector<std::vector<std::size_t>> columnsOfRow(rowCount);
+        for (std::size_t row = 0; row < rowCount; ++row) {
+            columnsOfRow[row] = pickDefault(table, row, productionsOfRow[row], marks);
+        }
+
+        std::vector<std::size_t> order(rowCount);
+        for (std::size_t row = 0; row < rowCount; ++row) { order[row] = row; }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return columnsOfRow[a].size() > columnsOfRow[b].size();
+        });
+
+        std::size_t firstFree = 0;
+        for (auto row : order) { place(table, row, columnsOfRow[row], firstFree); }
+    }
+
+    /**
+     * @brief Compress some rows again after they change in the dense table.
+     *
+     * The other rows keep their displacements, and the changed rows take the first fit
+     * displacements again. If the table has another shape, it is built again.
+     */
+    void update(const LL1Table &table, const ProductionList &pl, const std::vector<std::size_t> &rows) {
+        if (rowCount != table.rowCount() || columnCount != table.columnCount()) {
+            build(table, pl);
+            return;
+        }
+        for (auto row : rows) {
+            for (std::size_t column = 0; column < columnCount; ++column) {
+                auto index = static_cast<std::size_t>(base[row]) + column;
+                if (index < check.size() && check[index] == static_cast<Index>(row)) { check[index] = noRow; }
+            }
+            base[row] = 0;
+        }
+
+        std::size_t firstFree = 0;
+        while (!isFree(firstFree)) { ++firstFree; }
+        auto productionsOfRow = groupByRow(table, pl);
+        std::vector<std::size_t> marks;
+        for (auto row : rows) {
+            auto columns = pickDefault(table, row, productionsOfRow[row], marks);
+            place(table, row, columns, firstFree);
+        }
+    }
+
+    void clear() {
+        rowCount = 0;
+        columnCount = 0;
+        base.clear();
+        defaults.clear();
+        entries.clear();
+        check.clear();
+    }
+
+    void dump() const {
+        printf("[dump-compressed-ll1-table-begin]\n");
+        printf("  rows = %zu, columns = %zu, entries = %zu\n", rowCount, columnCount, entries.size());
+        printf("  dense bytes = %zu, compressed bytes = %zu, compression ratio = %.2f\n", denseByteSize(),
+               byteSize(), compressionRatio());
+        printf("[dump-compressed-ll1-table-end]\n\n");
+    }
+
+private:
+    bool isFree(std::size_t index) const { return index >= check.size() || check[index] == noRow; }
+
+    using ProductionRefs = std::vector<const Production *>;
+
+    static std::vector<ProductionRefs> groupByRow(const LL1Table &table, const ProductionList &pl) {
+        std::vector<ProductionRefs> productionsOfRow(table.rowCount());
+        for (auto &p : pl) { productionsOfRow[table.rowOfSymbol[p.lhs.symbol->id()]].push_back(&p); }
+        return productionsOfRow;
+    }
+
+    /**
+     * @brief Pick the default of a row, it is emptyCell unless a cell covers most of the columns.
+     *
+     * @param[in] productions   The productions of the row, their predict sets give the non-empty cells.
+     * @param[in,out] marks     Column index mapping the last row(plus 1) which has collected it.
+     * @return The columns whose cells differ from the default, they are sorted.
+     */
+    std::vector<std::size_t> pickDefault(const LL1Table &table, std::size_t row, const ProductionRefs &productions,
+                                         std::vector<std::size_t> &marks) {
+        marks.resize(columnCount, 0);
+        std::vector<std::size_t> columns;
+        for (auto p : productions) {
+            for (auto id : p->rhs.predictSet) {
+                auto column = table.columnOfSymbol[id];
+                if (column == LL1Table::npos || marks[column] == row + 1) { continue; }
+                marks[column] = row + 1;
+                columns.push_back(column);
+            }
+        }
+        std::sort(columns.begin(), columns.end());
+
+        // Only a majority cell can cover most of the columns, it is found by one vote.
+        Cell candidate = LL1Table::emptyCell;
+        std::size_t votes = 0;
+        for (auto column : columns) {
+            auto cell = table.at(row, column);
+            if (votes == 0) {
+                candidate = cell;
+                votes = 1;
+            } else if (cell == candidate) {
+                ++votes;
+            } else {
+                --votes;
+            }
+        }
+        auto count = std::count_if(columns.begin(), columns.end(),
+                                   [&](std::size_t column) { return table.at(row, column) == candidate; });
+        defaults[row] = static_cast<std::size_t>(count) * 2 > columnCount ? candidate : LL1Table::emptyCell;
+        if (defaults[row] == LL1Table::emptyCell) { return columns; }
+
+        columns.clear();
+        for (std::size_t column = 0; column < columnCount; ++column) {
+            if (table.at(row, column) != defaults[row]) { columns.push_back(column); }
+        }
+        return columns;
+    }
+
+    /**
+     * @brief Place the packed cells of a row at the lowest displacement where they all fit.
+     */
+    void place(const LL1Table &table, std::size_t row, const std::vector<std::size_t> &columns, std::size_t &firstFree) {
+        if (columns.empty()) { return; }
+
+        auto displacement = firstFree > columns.front() ? firstFree - columns.front() : 0;
+        while (!std::all_of(columns.begin(), columns.end(),
+                            [&](std::size_t column) { return isFree(displacement + column); })) {
+            ++displacement;
+        }
+
+        base[row] = static_cast<Index>(displacement);
+        auto size = displacement + columns.back() + 1;
+        if (check.size() < size) {
+            check.resize(size, noRow);
+            entries.resize(size, LL1Table::emptyCell);
+        }
+        for (auto column : columns) {
+            check[displacement + column] = static_cast<Index>(row);
+            entries[displacement + column] = table.at(row, column);
+        }
+        while (!isFree(firstFree)) { ++firstFree; }
+    }
+};
+
 /**
  * @brief Some helper functions for building html.
  */
 namespace html {
 inline std::string quota(std::string text) { return "\"" + text + "\""; }
 inline std::string line(std::string text) { return text + "\n"; }
-inline std::string formatCell(std::string text) {
+inline std::string formatCell(std::string_view text) {
     std::string str;
     for (auto &c : text) {
         if (c == ' ') {
@@ -312,254 +907,468 @@ inline std::string formatCell(std::string text) {
 class LRxStateFamily;
 using LRxStateFamilyPtr = std::shared_ptr<LRxStateFamily>;
 
+/**
+ * @brief A family of LR states(the canonical collection) of a grammar.
+ *
+ * Items of all the productions are numbered densely, so an item is just an id, and
+ * a state is identified by its sorted kernel item ids. States are found by hashing
+ * the kernel, so creating or finding a state never compares whole item sets.
+ * The closure of a state is not kept, it is computed again when it is needed.
+ */
 class LRxStateFamily {
 public:
+    using ItemId = std::uint32_t;
+    using ItemList = std::vector<ItemId>;
+
     /**
-     * @brief A state is a collection of items.
+     * @brief An item is just a production with a dot.
      */
-    struct State;
-    using StatePtr = State *;
-    struct State {
-        /**
-         * @brief An item is just a production with a dot.
-         */
-        struct Item {
-            using ProductionPtr = const Production *;
-            using Dot = std::size_t;
+    struct Item {
+        using ProductionPtr = const Production *;
+        using Dot = std::size_t;
 
-            ProductionPtr p;    ///< A production reference.
-            Dot dot;            ///< Dot at the production's right hand side.
+        ProductionPtr p = nullptr;    ///< A production reference.
+        Dot dot = 0;                  ///< Dot at the production's right hand side.
+        SymbolPtr next = nullptr;     ///< The symbol after the dot, nullptr if the item is complete.
 
-            Item(ProductionPtr p, Dot dot = 0) : p(p), dot(dot) {}
-            Item(const Item &other) {
-                this->p = other.p;
-                this->dot = other.dot;
-            }
+        bool isComplete() const { return next == nullptr; }
+        void dump(std::size_t indent = 2) const {
+            std::cout << std::string(indent, ' ');
+            std::cout << this->p->lhs.symbol->name();
+            std::cout << " ->";
 
-            bool operator == (Item other)const{
-                return std::tie(p, dot) == std::tie(other.p, other.dot);
+            auto &symbolList = this->p->rhs.symbolList;
+            for (std::size_t i = 0; i < symbolList.size(); ++i) {
+                if (i == this->dot) { std::cout << " ."; }
+                std::cout << " " << symbolList[i]->name();
             }
-            
-            bool operator != (const Item& other)const{
-                return std::tie(p, dot) != std::tie(other.p, other.dot);
-            }
-            bool operator<(const Item &other) const {
-                return std::tie(p, dot) < std::tie(other.p, other.dot);
-            }
-            void dump(std::size_t indent = 2)const{
-                std::cout << std::string(indent, ' ');
-                std::cout << this->p->lhs.symbol->name();
-                std::cout << " ->";
-
-                auto& symbolList = this->p->rhs.symbolList;
-                for(auto i = 0; i < this->dot; ++i){
-                    std::cout << " " << symbolList[i]->name();
-                }
-                std::cout << " .";
-                for(auto i = this->dot; i < symbolList.size(); ++i){
-                    std::cout << " " << symbolList[i]->name();
-                }
-                std::cout << "\n";
-            }
-        };
+            if (isComplete()) { std::cout << " ."; }
+            std::cout << "\n";
+        }
+    };
 
-        using ItemPtr = Item *;
-        using ItemSet = std::set<ItemPtr>;
+    struct State;
+    using StatePtr = State *;
+    struct State {
+        using Transition = std::pair<SymbolId, StatePtr>;
 
-        ItemSet items;              ///< All the items.
-        mutable int id = -1;        ///< This state id.
+        int id = -1;                            ///< This state id.
+        std::size_t hash = 0;                   ///< Hash of the kernel.
+        ItemList kernel;                        ///< Sorted kernel items, they identify the state.
+        std::vector<Transition> transitions;    ///< Goto states sorted by symbol id.
+        std::vector<int> reductions;            ///< Production ids of the complete items, sorted.
 
-        State() {}
-        State(const State &other) {
-            this->items = other.items;
-            this->id = other.id;
-        }
-        State &operator=(const State &other) {
-            if (this != &other) {
-                this->items = other.items;
-                this->id = other.id;
-            }
-            return *this;
-        }
-        bool insertItem(ItemPtr item) { return (items.insert(item).second); }
-        bool empty() const { return items.empty(); }
-        bool operator==(const State &other) const { 
-            return (this->items == other.items); 
-        }
-        bool operator!=(const State &other) const { 
-            return this->items != other.items; 
-        }
-        bool operator<(const State &other) const { 
-            return (this->items < other.items); 
-        }
-        void dump(int indent = 2)const{
-            for(auto& item : this->items){
-                item->dump(indent);
-            }
+        StatePtr gotoState(SymbolId symbol) const {
+            auto it = std::lower_bound(transitions.begin(), transitions.end(), Transition{symbol, nullptr},
+                                       [](const Transition &a, const Transition &b) { return a.first < b.first; });
+            return it != transitions.end() && it->first == symbol ? it->second : nullptr;
         }
     };
 
-    using Item = State::Item;
-    using ItemPtr = State::ItemPtr;
-    using StateTable = std::map<State, StatePtr>;
-    using ItemTable = std::map<Item, ItemPtr>;
+    using ItemTable = std::vector<Item>;         ///< Item id mapping item.
+    using StateTable = std::vector<StatePtr>;    ///< State id mapping state.
 
-    LRxStateFamily() {}
-    ~LRxStateFamily() {
-        for (auto &pair : itemTable_) { delete pair.second; }
-        for (auto &pair : stateTable_) { delete pair.second; }
+    /**
+     * @brief Scratch memory used to expand states, every thread needs its own.
+     */
+    struct Workspace {
+        std::vector<std::size_t> mark;         ///< Symbol id mapping the stamp it is visited.
+        std::size_t stamp = 0;                 ///< Stamp of the current closure.
+        std::vector<SymbolPtr> stack;          ///< Nonterminals to be closed.
+        ItemList items;                        ///< Items of the current closure.
+        std::vector<ItemList> kernels;         ///< Symbol id mapping the kernel of its goto state.
+        std::vector<SymbolId> symbols;         ///< Symbols which have goto states, sorted.
+    };
+
+    LRxStateFamily(GrammarContextPtr gc) : gc_(gc) {
+        auto &pl = gc_->pl->table();
+        productionsOf_.resize(gc_->st->symbolCount());
+        itemBase_.reserve(pl.size());
+        for (auto &p : pl) {
+            productionsOf_[p.lhs.symbol->id()].push_back(&p);
+            itemBase_.push_back(static_cast<ItemId>(itemTable_.size()));
+            auto &symbolList = p.rhs.symbolList;
+            auto length = symbolList.size() == 1 && symbolList.front()->isTerminalEpsilon() ? 0 : symbolList.size();
+            for (std::size_t dot = 0; dot <= length; ++dot) {
+                itemTable_.push_back({&p, dot, dot < length ? symbolList[dot] : nullptr});
+            }
+        }
     }
+    LRxStateFamily(const LRxStateFamily &) = delete;
+    LRxStateFamily &operator=(const LRxStateFamily &) = delete;
 
-    StatePtr findState(const State &other) { return stateTable_[other]; }
-    StatePtr createNewState(const State &other) {
+    GrammarContextPtr grammarContext() const { return gc_; }
+    ItemId itemId(const Production &p, Item::Dot dot = 0) const { return itemBase_[p.id] + static_cast<ItemId>(dot); }
+    const Item &getItem(ItemId id) const { return itemTable_[id]; }
+    const ItemTable &itemTable() const { return std::ref(itemTable_); }
+    StatePtr getState(std::size_t id) const { return stateTable_[id]; }
+    const StateTable &stateTable() const { return std::ref(stateTable_); }
+    std::size_t stateCount() const { return stateTable_.size(); }
+    bool empty() const { return stateTable_.empty(); }
 
-        auto &state = stateTable_[other];
-        if (state == nullptr) {
-            state = new State(other);
-            state->id = nextStateId_++;
-        }
-        return state;
+    static std::size_t hashOf(const ItemList &kernel) {
+        std::size_t hash = 14695981039346656037ULL;
+        for (auto id : kernel) { hash = (hash ^ id) * 1099511628211ULL; }
+        return hash;
     }
-    ItemPtr createNewItem(const Item &other) {
-        auto &item = itemTable_[other];
-        if (item == nullptr) { 
-            item = new Item(other); 
-        }
 
-        return item;
+    /**
+     * @brief Find a state by its kernel.
+     *
+     * @param[in] kernel    Sorted kernel items.
+     * @return StatePtr     The state, or nullptr if not found.
+     */
+    StatePtr findState(const ItemList &kernel) const {
+        if (index_.empty()) { return nullptr; }
+        auto slot = findSlot(kernel, hashOf(kernel));
+        return index_[slot] != npos ? stateTable_[index_[slot]] : nullptr;
     }
-    const StateTable &stateTable() const { return std::ref(stateTable_); }
-    const ItemTable &itemTable() const { return std::ref(itemTable_); }
-    bool empty(){
-        return stateTable_.empty()  || itemTable_.empty();
+
+    /**
+     * @brief Find a state by its kernel, or create it with the next state id.
+     *
+     * @param[in] kernel    Sorted kernel items.
+     * @return The state, and true if it is created.
+     */
+    std::pair<StatePtr, bool> createNewState(ItemList kernel) {
+        if ((stateTable_.size() + 1) * 2 > index_.size()) { rehash(index_.empty() ? 64 : index_.size() * 2); }
+
+        auto hash = hashOf(kernel);
+        auto slot = findSlot(kernel, hash);
+        if (index_[slot] != npos) { return {stateTable_[index_[slot]], false}; }
+
+        index_[slot] = stateTable_.size();
+        return {appendState(std::move(kernel), hash), true};
     }
 
-    LRxStateFamilyPtr clone(){
-        LRxStateFamilyPtr sf = std::make_shared<LRxStateFamily>();
-        sf->stateTable_ = this->stateTable_;
-        sf->itemTable_ = this->itemTable_;
-        return sf;
+    /**
+     * @brief Create a state with the next state id, even if a state has the same kernel.
+     *
+     * LR(1) states may share a kernel, findState() finds the first one of them.
+     *
+     * @param[in] kernel    Sorted kernel items.
+     */
+    StatePtr createSharedState(ItemList kernel) {
+        auto state = findState(kernel);
+        if (state == nullptr) { return createNewState(std::move(kernel)).first; }
+        return appendState(std::move(kernel), state->hash);
     }
-    void setStateTable(const StateTable& stateTable){
-        stateTable_ = stateTable;
+
+    /**
+     * @brief Compute the closure of a kernel.
+     *
+     * @param[in] kernel    Kernel items.
+     * @param[out] items    The kernel items followed by the closure items.
+     * @param[in] ws        Workspace.
+     */
+    void closure(const ItemList &kernel, ItemList &items, Workspace &ws) const {
+        if (ws.mark.size() < productionsOf_.size()) { ws.mark.resize(productionsOf_.size(), 0); }
+        ++ws.stamp;
+
+        items.assign(kernel.begin(), kernel.end());
+        auto visit = [&](SymbolPtr symbol) {
+            if (symbol == nullptr || symbol->isTerminal() || ws.mark[symbol->id()] == ws.stamp) { return; }
+            ws.mark[symbol->id()] = ws.stamp;
+            ws.stack.push_back(symbol);
+        };
+
+        for (auto id : kernel) { visit(itemTable_[id].next); }
+        while (!ws.stack.empty()) {
+            auto symbol = ws.stack.back();
+            ws.stack.pop_back();
+            for (auto p : productionsOf_[symbol->id()]) {
+                auto id = itemId(*p);
+                items.push_back(id);
+                visit(itemTable_[id].next);
+            }
+        }
     }
-    void setItemTable(const ItemTable& itemTable){
-        itemTable_ = itemTable;
+
+    /**
+     * @brief Collect the kernels of the goto states of some closed items into the workspace.
+     *
+     * After it, ws.symbols are the symbols after dots, and ws.kernels[symbol] is the sorted
+     * kernel of the goto state on the symbol.
+     */
+    void gotoKernels(const ItemList &items, Workspace &ws) const {
+        if (ws.kernels.size() < productionsOf_.size()) { ws.kernels.resize(productionsOf_.size()); }
+        for (auto symbol : ws.symbols) { ws.kernels[symbol].clear(); }
+        ws.symbols.clear();
+
+        for (auto id : items) {
+            auto next = itemTable_[id].next;
+            if (next == nullptr) { continue; }
+            auto &kernel = ws.kernels[next->id()];
+            if (kernel.empty()) { ws.symbols.push_back(next->id()); }
+            kernel.push_back(id + 1);
+        }
+
+        std::sort(ws.symbols.begin(), ws.symbols.end());
+        for (auto symbol : ws.symbols) {
+            auto &kernel = ws.kernels[symbol];
+            std::sort(kernel.begin(), kernel.end());
+        }
     }
 
-    void dumpStateTable(std::size_t indent = 2)const{
+    /**
+     * @brief Close a state, collect its reductions, then find or create all its goto states.
+     */
+    void expand(State &state, Workspace &ws) {
+        closure(state.kernel, ws.items, ws);
+        state.reductions.clear();
+        for (auto id : ws.items) {
+            if (itemTable_[id].isComplete()) { state.reductions.push_back(itemTable_[id].p->id); }
+        }
+        std::sort(state.reductions.begin(), state.reductions.end());
+
+        gotoKernels(ws.items, ws);
+        state.transitions.clear();
+        for (auto symbol : ws.symbols) {
+            auto target = createNewState(ws.kernels[symbol]).first;
+            state.transitions.push_back({symbol, target});
+        }
+    }
+
+    void dumpStateTable(std::size_t indent = 2) const {
         std::cout << "[dump-state-table-begin]\n";
-        for(auto& pair : this->stateTable()){
-            std::cout << std::string(indent, ' ') << "[" << pair.second->id << "]\n";
-            pair.second->dump(indent + 2);
+        Workspace ws;
+        for (auto state : stateTable_) {
+            std::cout << std::string(indent, ' ') << "[" << state->id << "]\n";
+            closure(state->kernel, ws.items, ws);
+            for (auto id : ws.items) { itemTable_[id].dump(indent + 2); }
+            for (auto &[symbol, target] : state->transitions) {
+                std::cout << std::string(indent + 2, ' ') << gc_->st->getSymbol(symbol)->name() << " => ["
+                          << target->id << "]\n";
+            }
         }
         std::cout << "[dump-state-table-end]\n\n";
     }
-    void dumpItemTable(std::size_t indent = 2)const{
+    void dumpItemTable(std::size_t indent = 2) const {
         std::cout << "[dump-item-table-begin]\n";
-        int i = 0;
-        for(auto&item: itemTable_){
+        for (std::size_t i = 0; i < itemTable_.size(); ++i) {
             std::cout << std::string(indent, ' ');
-            printf("[%02d]", i++);
-            item.second->dump();
+            printf("[%02zu]", i);
+            itemTable_[i].dump();
         }
         std::cout << "[dump-item-table-end]\n\n";
     }
 
 private:
-    int nextStateId_ = 0;
-    StateTable stateTable_;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    std::size_t findSlot(const ItemList &kernel, std::size_t hash) const {
+        auto mask = index_.size() - 1;
+        auto slot = hash & mask;
+        while (index_[slot] != npos) {
+            auto state = stateTable_[index_[slot]];
+            if (state->hash == hash && state->kernel == kernel) { break; }
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(std::size_t size) {
+        index_.assign(size, npos);
+        for (auto state : stateTable_) {
+            auto slot = findSlot(state->kernel, state->hash);
+            if (index_[slot] == npos) { index_[slot] = state->id; }
+        }
+    }
+
+    StatePtr appendState(ItemList kernel, std::size_t hash) {
+        auto &state = states_.emplace_back();
+        state.id = static_cast<int>(stateTable_.size());
+        state.hash = hash;
+        state.kernel = std::move(kernel);
+        stateTable_.push_back(&state);
+        return &state;
+    }
+
+    GrammarContextPtr gc_;
     ItemTable itemTable_;
+    std::vector<ItemId> itemBase_;                              ///< Production id mapping its first item.
+    std::vector<std::vector<const Production *>> productionsOf_;  ///< Symbol id mapping its productions.
+    std::deque<State> states_;                                  ///< State storage, the addresses are stable.
+    StateTable stateTable_;
+    std::vector<std::size_t> index_;                            ///< Open addressing hash index of state ids.
 };
 
 /**
- * @brief A uniform LR(0), LR(1), LALR table.
- * 
- * It is a data objct.
- * It is a data object as an interface.
- * It is to be produced or consumed by other objects.
+ * @brief A dense LR(0), LR(1), LALR table.
+ *
+ * It is a data object produced by the LRx analyzers, and consumed by parse engines and exporters.
+ * Rows are state ids, columns are the terminals in the order of symbol id, then the nonterminals.
+ * Every cell is one packed 32-bit action word, so a lookup is O(1) and the cells can be copied
+ * as plain memory. A cell with more than one action holds a conflict word, and its actions are
+ * stored in the conflicts side list, which is also plain memory.
  */
 struct LRxTable {
-    using StatePtr = LRxStateFamily::StatePtr;
+    using Word = std::uint32_t;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Action of a LR table's cell, packed as (target << typeBits) | type.
+     */
+    class Action {
+    public:
+        enum class Type : Word { Error = 0, Goto, Reduce, Accept, Conflict };
+        static constexpr Word typeBits = 3;
+        static constexpr Word typeMask = (Word(1) << typeBits) - 1;
+        static constexpr Word maxTarget = ~Word(0) >> typeBits;
 
-    struct Cell {
-        StatePtr state;     ///< Y coordinate in the table.
-        SymbolPtr symbol;   ///< X coordinate in the table.
+        constexpr Action() = default;
+        constexpr Action(Type type, Word target = 0) : word_((target << typeBits) | static_cast<Word>(type)) {}
 
-        Cell(StatePtr state = nullptr, SymbolPtr symbol = nullptr)
-            : state(state), symbol(symbol) {}
-        bool operator<(const Cell &other) const {
-            if (this->state < other.state) {
-                return true;
-            } else {
-                if (this->symbol < other.symbol) { return true; }
-                return false;
+        static Action makeGoto(std::size_t state) { return {Type::Goto, checkedTarget(state)}; }
+        static Action makeReduce(std::size_t pid) { return {Type::Reduce, checkedTarget(pid)}; }
+        static Action makeAccept() { return {Type::Accept}; }
+
+        Type type() const { return static_cast<Type>(word_ & typeMask); }
+        Word target() const { return word_ >> typeBits; }
+        Word word() const { return word_; }
+        bool isError() const { return word_ == 0; }
+
+        int gotoState() const { return type() == Type::Goto ? static_cast<int>(target()) : -1; }
+        int reducePid() const { return type() == Type::Reduce ? static_cast<int>(target()) : -1; }
+
+        bool operator<(const Action &other) const { return word_ < other.word_; }
+        bool operator==(const Action &other) const { return word_ == other.word_; }
+        bool operator!=(const Action &other) const { return word_ != other.word_; }
+
+        std::string toString() const {
+            if (type() == Type::Accept) {
+                return "Accept";
+            } else if (type() == Type::Goto) {
+                return "S" + std::to_string(target());    // Goto state id.
+            } else if (type() == Type::Reduce) {
+                return "R" + std::to_string(target());    // Reduce production id.
             }
+            return {};
         }
-        bool operator==(const Cell &other) const {
-            if (this->state == other.state && this->symbol == other.symbol) { return true; }
-            return false;
+
+    private:
+        static Word checkedTarget(std::size_t target) {
+            assert(target <= maxTarget);
+            return static_cast<Word>(target);
         }
-        bool operator!=(const Cell &other) const { return !(*this == other); }
+
+        Word word_ = 0;
     };
+    static_assert(sizeof(Action) == sizeof(Word) && std::is_trivially_copyable_v<Action>);
 
     /**
-     * @brief Action of a LR table's cell.
+     * @brief A cell with more than one action, its actions are sorted in conflictActions[begin, begin + size).
      */
-    struct Action {
-        enum class Type : int { Error = 0, Goto, Reduce, Accept };
+    struct Conflict {
+        std::uint64_t cell;    ///< Cell index.
+        Word begin;            ///< Index of the first action.
+        Word size;             ///< Count of the actions.
+    };
+    static_assert(std::is_trivially_copyable_v<Conflict>);
 
-        Type type = Type::Error;        ///< Action type.
-        StatePtr gotoState = nullptr;   ///< Goto target state, valid if type == Type::Goto.
-        int reducePid = -1;             ///< Reduce production id, valid if type == Type::Reduce.
+    std::size_t stateCount = 0;                  ///< Row count.
+    std::size_t terminalCount = 0;               ///< The front columns are terminals.
+    SymbolList symbols;                          ///< Column index mapping symbol.
+    std::vector<std::size_t> columnOfSymbol;     ///< Symbol id mapping column index or npos.
+    std::vector<Action> cells;                   ///< All the cells in row major order.
+    std::vector<Conflict> conflicts;             ///< Conflict word's target mapping the conflict, in cell order.
+    std::vector<Action> conflictActions;         ///< Actions of all the conflicts.
 
-        bool operator<(const Action &other) const {
-            if (this->type < other.type) {
-                return true;
-            } else {
-                if (this->gotoState < other.gotoState) {
-                    return true;
-                } else {
-                    if (this->reducePid < other.reducePid) { return true; }
-                    return false;
-                }
-            }
-        }
-        bool operator==(const Action &other) const {
-            return this->type == other.type && this->gotoState == other.gotoState &&
-                    this->reducePid == other.reducePid;
-        }
-        bool operator!=(const Action &other) const { return !(*this == other); }
-        std::string toString() const {
-            if (this->type == Type::Accept) {
-                return "Accept";
-            } else if (this->type == Type::Goto) {
-                assert(this->gotoState != nullptr);
-                return "S" + std::to_string(this->gotoState->id); // Goto state id.
-            } else if (this->type == Type::Reduce) {
-                assert(this->reducePid >= 0);
-                return "R" + std::to_string(this->reducePid);   // Reduce production id.
+    std::size_t rowCount() const { return stateCount; }
+    std::size_t columnCount() const { return symbols.size(); }
+    std::size_t cellIndex(std::size_t row, std::size_t column) const { return row * symbols.size() + column; }
+    Action at(std::size_t row, std::size_t column) const { return cells[cellIndex(row, column)]; }
+    std::size_t rowOf(std::size_t cell) const { return cell / symbols.size(); }
+    SymbolPtr symbolOf(std::size_t cell) const { return symbols[cell % symbols.size()]; }
+
+    /**
+     * @brief Find the cell of a state and a symbol.
+     *
+     * @return Action   The cell, or an error action if the symbol is not in the table.
+     */
+    Action find(std::size_t state, SymbolPtr symbol) const {
+        auto column = symbol && symbol->id() < columnOfSymbol.size() ? columnOfSymbol[symbol->id()] : npos;
+        if (state >= stateCount || column == npos) { return {}; }
+        return at(state, column);
+    }
+
+    /**
+     * @brief Get all the actions of a cell, they are sorted.
+     */
+    std::vector<Action> actionsAt(std::size_t row, std::size_t column) const {
+        auto action = at(row, column);
+        if (action.type() == Action::Type::Conflict) { return actionsOf(conflicts[action.target()]); }
+        if (action.isError()) { return {}; }
+        return {action};
+    }
+
+    std::vector<Action> actionsOf(const Conflict &conflict) const {
+        auto begin = conflictActions.begin() + conflict.begin;
+        return {begin, begin + conflict.size};
+    }
+
+    bool hasConflict() const { return !conflicts.empty(); }
+    std::size_t byteSize() const {
+        return (cells.size() + conflictActions.size()) * sizeof(Action) + conflicts.size() * sizeof(Conflict);
+    }
+
+    /**
+     * @brief Clear the table and give it the size of some states and columns, all the cells are errors.
+     *
+     * @param[in] theStateCount     Row count.
+     * @param[in] columns           Column index mapping symbol, terminals first.
+     * @param[in] theTerminalCount  Count of the terminal columns.
+     * @param[in] symbolCount       Symbol count of the symbol table.
+     */
+    void reset(std::size_t theStateCount, const SymbolList &columns, std::size_t theTerminalCount,
+               std::size_t symbolCount) {
+        clear();
+        stateCount = theStateCount;
+        terminalCount = theTerminalCount;
+        symbols = columns;
+        columnOfSymbol.assign(symbolCount, npos);
+        for (std::size_t column = 0; column < symbols.size(); ++column) { columnOfSymbol[symbols[column]->id()] = column; }
+        cells.assign(stateCount * symbols.size(), Action());
+    }
+
+    /**
+     * @brief Add an action to a cell, a cell which already has another action becomes a conflict.
+     *
+     * Cells must be added in row major order, and the actions of a cell one after another,
+     * so a conflict only grows at the back of the side list.
+     */
+    void add(std::size_t row, std::size_t column, Action action) {
+        auto index = cellIndex(row, column);
+        auto &cell = cells[index];
+        if (cell.isError()) {
+            cell = action;
+        } else if (cell.type() == Action::Type::Conflict) {
+            auto &conflict = conflicts[cell.target()];
+            assert(cell.target() + 1 == conflicts.size());
+            auto begin = conflictActions.begin() + conflict.begin;
+            auto it = std::lower_bound(begin, conflictActions.end(), action);
+            if (it == conflictActions.end() || *it != action) {
+                conflictActions.insert(it, action);
+                ++conflict.size;
             }
-            return {};
+        } else if (cell != action) {
+            assert(conflicts.empty() || conflicts.back().cell < index);
+            conflicts.push_back({index, static_cast<Word>(conflictActions.size()), 2});
+            conflictActions.push_back(std::min(cell, action));
+            conflictActions.push_back(std::max(cell, action));
+            cell = Action(Action::Type::Conflict, static_cast<Word>(conflicts.size() - 1));
         }
-    };
-    
-    using ActionSet = std::set<Action>;
-
-    void clear(){
-        idMappingState.clear();
-        idMappingSymbol.clear();
-        cellMappingAction.clear();
-    }
-
-    // state-id mapping state.
-    std::map<int, StatePtr> idMappingState;
-    // symbol-id mapping symbol.
-    // The front part is terminal.
-    // The back part is nonterminal.
-    std::map<int, SymbolPtr> idMappingSymbol;
-    // All the table cell's infomation.
-    std::map<Cell, ActionSet> cellMappingAction;
+    }
+
+    void clear() {
+        stateCount = 0;
+        terminalCount = 0;
+        symbols.clear();
+        columnOfSymbol.clear();
+        cells.clear();
+        conflicts.clear();
+        conflictActions.clear();
+    }
 };
 
 }    // namespace csa
\ No newline at end of file
@@ -0,0 +1,75 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace csa {
+
+/**
+ * @brief A hash map which many threads can find or insert into at the same time.
+ *
+ * Keys are spread over shards by their hash, and every shard has its own lock,
+ * so threads only wait for each other when their keys fall into the same shard.
+ *
+ * @tparam Key      Key type.
+ * @tparam Value    Value type, it should be cheap to copy, such as a pointer.
+ * @tparam Hash     Hash of the key.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ConcurrentHashMap {
+public:
+    explicit ConcurrentHashMap(std::size_t shardCount = 64) : shards_(shardCount ? shardCount : 1) {}
+    ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+    ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+    /**
+     * @brief Find the value of a key, or insert the value made by a factory.
+     *
+     * The factory is called under the shard lock, and only by the thread which inserts the key,
+     * so a value is never made and thrown away.
+     *
+     * @param[in] key       The key.
+     * @param[in] hash      Hash(key), it is given so the caller can compute it once.
+     * @param[in] make      Factory of the value, Value make().
+     * @return The value, and true if it is inserted.
+     */
+    template <typename Factory>
+    std::pair<Value, bool> findOrInsert(const Key &key, std::size_t hash, Factory &&make) {
+        auto &shard = shards_[(hash >> 7) % shards_.size()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) { return {it->second, false}; }
+        auto value = make();
+        shard.map.emplace(key, value);
+        return {value, true};
+    }
+
+    std::size_t size() const {
+        std::size_t count = 0;
+        for (auto &shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            count += shard.map.size();
+        }
+        return count;
+    }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Value, Hash> map;
+    };
+
+    std::deque<Shard> shards_;
+};
+
+}    // namespace csa
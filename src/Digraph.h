@@ -0,0 +1,231 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+#include "WorkStealingPool.h"
+
+namespace csa {
+
+/**
+ * @brief A relation on nodes [0, n), relation[x] is the list of y where (x R y).
+ */
+using Relation = std::vector<std::vector<std::size_t>>;
+
+/**
+ * @brief DeRemer and Pennello's digraph algorithm.
+ *
+ * It solves F(x) = F'(x) + { F(y) | x R y } for all the nodes, where F'(x) is the input
+ * value of sets[x]. Strongly connected components are collapsed with a Tarjan-style
+ * traversal, so every component is computed in one pass and all its nodes share a result.
+ * The traversal uses an explicit stack so deep relations cannot overflow the call stack.
+ *
+ * @param[in] relation      Input relation.
+ * @param[in,out] sets      Input F'(x), output F(x), sets.size() must be relation.size().
+ * @return std::size_t      The count of strongly connected components.
+ */
+inline std::size_t digraph(const Relation &relation, std::vector<SymbolSet> &sets) {
+    assert(relation.size() == sets.size());
+
+    constexpr std::size_t infinity = static_cast<std::size_t>(-1);
+
+    struct Frame {
+        std::size_t node;     ///< The node being traversed.
+        std::size_t depth;    ///< Stack depth when the node is pushed.
+        std::size_t edge;     ///< Next edge to visit.
+    };
+
+    std::size_t sccCount = 0;
+    std::vector<std::size_t> mark(relation.size(), 0);
+    std::vector<std::size_t> stack;
+    std::vector<Frame> frames;
+
+    auto push = [&](std::size_t x) {
+        stack.push_back(x);
+        mark[x] = stack.size();
+        frames.push_back({x, stack.size(), 0});
+    };
+
+    for (std::size_t root = 0; root < relation.size(); ++root) {
+        if (mark[root] != 0) { continue; }
+        push(root);
+
+        while (!frames.empty()) {
+            auto x = frames.back().node;
+            auto &edges = relation[x];
+
+            if (frames.back().edge < edges.size()) {
+                auto y = edges[frames.back().edge++];
+                if (mark[y] == 0) {
+                    push(y);
+                } else {
+                    mark[x] = std::min(mark[x], mark[y]);
+                    if (x != y) { sets[x].unite(sets[y]); }
+                }
+                continue;
+            }
+
+            // All the edges are visited, close the component if x is its root.
+            auto depth = frames.back().depth;
+            frames.pop_back();
+            if (mark[x] == depth) {
+                ++sccCount;
+                while (true) {
+                    auto top = stack.back();
+                    stack.pop_back();
+                    mark[top] = infinity;
+                    if (top == x) { break; }
+                    sets[top] = sets[x];
+                }
+            }
+
+            if (!frames.empty()) {
+                auto parent = frames.back().node;
+                mark[parent] = std::min(mark[parent], mark[x]);
+                sets[parent].unite(sets[x]);
+            }
+        }
+    }
+
+    return sccCount;
+}
+
+/**
+ * @brief Find the strongly connected components of a relation.
+ *
+ * A component is numbered when it is closed, which is after all the components it reaches,
+ * so the components in number order are a topological order from the leaves up.
+ *
+ * @param[in] relation      Input relation.
+ * @param[out] component    Node mapping its component.
+ * @return std::size_t      The count of strongly connected components.
+ */
+inline std::size_t stronglyConnectedComponents(const Relation &relation, std::vector<std::size_t> &component) {
+    constexpr std::size_t infinity = static_cast<std::size_t>(-1);
+
+    struct Frame {
+        std::size_t node;
+        std::size_t depth;
+        std::size_t edge;
+    };
+
+    std::size_t sccCount = 0;
+    std::vector<std::size_t> mark(relation.size(), 0);
+    std::vector<std::size_t> stack;
+    std::vector<Frame> frames;
+    component.assign(relation.size(), infinity);
+
+    auto push = [&](std::size_t x) {
+        stack.push_back(x);
+        mark[x] = stack.size();
+        frames.push_back({x, stack.size(), 0});
+    };
+
+    for (std::size_t root = 0; root < relation.size(); ++root) {
+        if (mark[root] != 0) { continue; }
+        push(root);
+
+        while (!frames.empty()) {
+            auto x = frames.back().node;
+            auto &edges = relation[x];
+
+            if (frames.back().edge < edges.size()) {
+                auto y = edges[frames.back().edge++];
+                if (mark[y] == 0) {
+                    push(y);
+                } else {
+                    mark[x] = std::min(mark[x], mark[y]);
+                }
+                continue;
+            }
+
+            auto depth = frames.back().depth;
+            frames.pop_back();
+            if (mark[x] == depth) {
+                while (true) {
+                    auto top = stack.back();
+                    stack.pop_back();
+                    mark[top] = infinity;
+                    component[top] = sccCount;
+                    if (top == x) { break; }
+                }
+                ++sccCount;
+            }
+
+            if (!frames.empty()) {
+                auto parent = frames.back().node;
+                mark[parent] = std::min(mark[parent], mark[x]);
+            }
+        }
+    }
+
+    return sccCount;
+}
+
+/**
+ * @brief The digraph algorithm on a thread pool, it gives the same sets as digraph().
+ *
+ * The relation is condensed into a DAG of strongly connected components. A component is solved
+ * as soon as all the components it reaches are solved: its members share the union of their
+ * input sets and the results of those components. Independent components are solved by
+ * different workers of a work-stealing pool.
+ *
+ * @param[in] relation      Input relation.
+ * @param[in,out] sets      Input F'(x), output F(x), sets.size() must be relation.size().
+ * @param[in] jobs          Count of the threads.
+ * @return std::size_t      The count of strongly connected components.
+ */
+inline std::size_t digraph(const Relation &relation, std::vector<SymbolSet> &sets, std::size_t jobs) {
+    assert(relation.size() == sets.size());
+    if (jobs <= 1) { return digraph(relation, sets); }
+
+    std::vector<std::size_t> component;
+    auto sccCount = stronglyConnectedComponents(relation, component);
+
+    // Members and successors of every component, and the components which wait for it.
+    Relation members(sccCount);
+    Relation successors(sccCount);
+    Relation dependents(sccCount);
+    for (std::size_t x = 0; x < relation.size(); ++x) { members[component[x]].push_back(x); }
+    std::vector<std::size_t> seen(sccCount, static_cast<std::size_t>(-1));
+    for (std::size_t c = 0; c < sccCount; ++c) {
+        for (auto x : members[c]) {
+            for (auto y : relation[x]) {
+                auto d = component[y];
+                if (d == c || seen[d] == c) { continue; }
+                seen[d] = c;
+                successors[c].push_back(d);
+                dependents[d].push_back(c);
+            }
+        }
+    }
+
+    std::vector<std::atomic<std::size_t>> waiting(sccCount);
+    WorkStealingPool<std::size_t> pool(jobs);
+    for (std::size_t c = 0; c < sccCount; ++c) {
+        waiting[c].store(successors[c].size(), std::memory_order_relaxed);
+        if (successors[c].empty()) { pool.push(c % jobs, c); }
+    }
+
+    pool.run([&](std::size_t c, std::size_t worker) {
+        auto &result = sets[members[c].front()];
+        for (std::size_t i = 1; i < members[c].size(); ++i) { result.unite(sets[members[c][i]]); }
+        for (auto d : successors[c]) { result.unite(sets[members[d].front()]); }
+        for (std::size_t i = 1; i < members[c].size(); ++i) { sets[members[c][i]] = result; }
+
+        for (auto d : dependents[c]) {
+            if (waiting[d].fetch_sub(1, std::memory_order_acq_rel) == 1) { pool.push(worker, d); }
+        }
+    });
+
+    return sccCount;
+}
+
+}    // namespace csa
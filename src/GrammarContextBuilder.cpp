@@ -18,31 +18,82 @@
 #endif
 #include "Lexer.h"
 
-#include <fstream>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CSA_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace csa;
 
-GrammarContextPtr GrammarContextBuilder::buildFromBuffer(std::vector<char> &buf){
-    if (buf.empty()) { return {}; }
-    if (buf.back() != '\n') { buf.push_back('\n'); }
-    // The last two bytes must be YY_END_OF_BUFFER_CHAR (ASCII NUL) for flex.
-    buf.push_back(0);
-    buf.push_back(0);
+#ifdef CSA_HAS_MMAP
+namespace {
 
-    yyscan_t scanner;
-    YY_BUFFER_STATE yyBufState;
+/**
+ * @brief A regular file mapped into memory with tail padding for flex.
+ *
+ * The file is mapped privately(copy on write) over a zero filled anonymous mapping
+ * which is a few bytes bigger than the file, so the newline and the two NUL sentinel
+ * bytes are appended without copying the file.
+ */
+class MappedFile {
+public:
+    MappedFile(const std::string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) { return; }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+            close(fd);
+            return;
+        }
+
+        auto fileSize = static_cast<std::size_t>(st.st_size);
+        auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        mapSize_ = (fileSize + 3 + pageSize - 1) / pageSize * pageSize;
+
+        void *base = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (base != MAP_FAILED) {
+            void *file = mmap(base, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+            if (file != MAP_FAILED) {
+                data_ = static_cast<char *>(file);
+                size_ = fileSize;
+                if (data_[size_ - 1] != '\n') { data_[size_++] = '\n'; }
+                size_ += 2;    // The two NUL bytes are already there.
+            } else {
+                munmap(base, mapSize_);
+            }
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (data_) { munmap(data_, mapSize_); }
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
 
-    ProductionList pl;
-    auto st = std::make_shared<csa::SymbolTable>();
+    bool good() const { return data_ != nullptr; }
+    char *data() { return data_; }
+    std::size_t size() const { return size_; }
 
-    yylex_init_extra(st, &scanner);
-    yyBufState = yy_scan_buffer(buf.data(), buf.size(), scanner);
+private:
+    char *data_ = nullptr;      ///< The mapped memory.
+    std::size_t size_ = 0;      ///< Size of the padded text.
+    std::size_t mapSize_ = 0;   ///< Size of the whole mapping.
+};
+
+}    // namespace
+#endif
+
+GrammarContextPtr GrammarContextBuilder::buildFromScanner(void *scanner, SymbolTablePtr st){
+    ProductionList pl;
     csa::Parser parser(scanner, pl, *st);
     if(parser.parse() != 0){ pl.clear(); }
 
-    yy_delete_buffer(yyBufState, scanner);
-    yylex_destroy(scanner);
-
     if(!pl.empty()){
         auto pt = std::make_shared<ProductionTable>(pl);
         return std::make_shared<GrammarContext>(pt, st);
@@ -51,10 +102,60 @@ GrammarContextPtr GrammarContextBuilder::buildFromBuffer(std::vector<char> &buf)
     return {};
 }
 
+GrammarContextPtr GrammarContextBuilder::buildFromBuffer(char *buf, std::size_t size){
+    // The last two bytes must be YY_END_OF_BUFFER_CHAR (ASCII NUL) for flex.
+    if (buf == nullptr || size <= 2 || buf[size - 2] != 0 || buf[size - 1] != 0) { return {}; }
+
+    yyscan_t scanner;
+    YY_BUFFER_STATE yyBufState;
+    GrammarContextPtr gc;
+    auto st = std::make_shared<csa::SymbolTable>();
+
+    yylex_init_extra(st, &scanner);
+    yyBufState = yy_scan_buffer(buf, size, scanner);
+    if (yyBufState) {
+        gc = buildFromScanner(scanner, st);
+        yy_delete_buffer(yyBufState, scanner);
+    }
+    yylex_destroy(scanner);
+
+    return gc;
+}
+
+GrammarContextPtr GrammarContextBuilder::buildFromFile(FILE *file){
+    if (file == nullptr) { return {}; }
+
+    yyscan_t scanner;
+    auto st = std::make_shared<csa::SymbolTable>();
+
+    // The scanner reads the file descriptor, flushing an input stream moves the descriptor to
+    // the stream position(POSIX). It can't on a pipe, which must not have been read.
+    fflush(file);
+
+    yylex_init_extra(st, &scanner);
+    yyset_in(file, scanner);
+    auto gc = buildFromScanner(scanner, st);
+    yylex_destroy(scanner);
+
+    return gc;
+}
+
+GrammarContextPtr GrammarContextBuilder::buildFromBuffer(std::vector<char> &buf){
+    if (buf.empty()) { return {}; }
+    if (buf.back() != '\n') { buf.push_back('\n'); }
+    buf.push_back(0);
+    buf.push_back(0);
+
+    return buildFromBuffer(buf.data(), buf.size());
+}
+
 GrammarContextPtr GrammarContextBuilder::buildFromStream(const std::string &stream) {
     if (stream.empty()) return {};
 
-    std::vector<char> buffer(stream.begin(), stream.end());
+    // Reserve the padding, so that appending it will not copy the buffer again.
+    std::vector<char> buffer;
+    buffer.reserve(stream.size() + 3);
+    buffer.assign(stream.begin(), stream.end());
 
     return buildFromBuffer(buffer);
 }
@@ -62,16 +163,19 @@ GrammarContextPtr GrammarContextBuilder::buildFromStream(const std::string &stre
 GrammarContextPtr GrammarContextBuilder::buildFromFile(const std::string &filename) {
     if (filename.empty()) return {};
 
-    std::ifstream ifs(filename);
-    std::vector<char> buffer;
-    if (ifs) {
-        std::istreambuf_iterator<char> begin(ifs);
-        std::istreambuf_iterator<char> end;
-        buffer.assign(begin, end);
-        return buildFromBuffer(buffer);
+#ifdef CSA_HAS_MMAP
+    MappedFile mappedFile(filename);
+    if (mappedFile.good()) { return buildFromBuffer(mappedFile.data(), mappedFile.size()); }
+#endif
+
+    auto file = fopen(filename.c_str(), "rb");
+    if (file) {
+        auto gc = buildFromFile(file);
+        fclose(file);
+        return gc;
     } else {
         printf("error, cannot read file = %s\n", filename.c_str());
     }
 
     return {};
-}
\ No newline at end of file
+}
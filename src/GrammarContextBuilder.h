@@ -13,13 +13,55 @@
 
 namespace csa {
 
+class GrammarImage;
+
 class GrammarContextBuilder {
 public:
     static GrammarContextPtr buildFromStream(const std::string &stream);
+
+    /**
+     * @brief Build from a grammar file.
+     *
+     * A regular file is memory mapped with tail padding and scanned in place,
+     * other files(such as pipes) are streamed by buildFromFile(FILE *).
+     */
     static GrammarContextPtr buildFromFile(const std::string &filename);
 
+    /**
+     * @brief Build from an opened file(such as stdin or a pipe).
+     *
+     * The file is read chunk by chunk while scanning, so the whole input is never held
+     * in memory, and parsing starts before the end of file. The file is not closed.
+     * Scanning starts at the position of the file; a pipe is read by its descriptor, so
+     * nothing of it may have been read through the file before.
+     */
+    static GrammarContextPtr buildFromFile(FILE *file);
+
+    /**
+     * @brief Build from a caller-owned buffer, it is scanned in place without copy.
+     *
+     * The last two bytes of the buffer must be NUL, they are the sentinel bytes of flex.
+     * The buffer is modified while scanning, and it is restored when this function returns.
+     *
+     * @param[in] buf           Input buffer.
+     * @param[in] size          Input buffer size, include the two NUL bytes.
+     * @return GrammarContextPtr    The grammar context, or nullptr if any error.
+     */
+    static GrammarContextPtr buildFromBuffer(char *buf, std::size_t size);
+
+    /**
+     * @brief Build from an opened grammar image, nothing is scanned or parsed.
+     *
+     * The symbols take the same ids as the image's, and the analysis results are
+     * loaded by LL1Analyzer::loadAnalysis(const GrammarImage &).
+     *
+     * @return GrammarContextPtr    The grammar context, or nullptr if the image is not opened.
+     */
+    static GrammarContextPtr buildFromImage(const GrammarImage &image);
+
 private:
     static GrammarContextPtr buildFromBuffer(std::vector<char> &buf);
+    static GrammarContextPtr buildFromScanner(void *scanner, SymbolTablePtr st);
 };
 
 }    // namespace csa
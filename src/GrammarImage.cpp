@@ -0,0 +1,524 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarImage.h"
+#include "GrammarContextBuilder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CSA_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace csa;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char magic[8] = {'C', 'S', 'A', 'I', 'M', 'A', 'G', 'E'};
+
+// The accessors read the numbers in place, so only a little endian host can open an image.
+bool isLittleEndianHost() {
+    const std::uint16_t one = 1;
+    unsigned char byte;
+    std::memcpy(&byte, &one, 1);
+    return byte == 1;
+}
+
+//
+// A section is built in little endian bytes, whatever the host is.
+//
+struct SectionData {
+    std::string bytes;
+    std::uint64_t size = 0;    ///< Count of the elements.
+
+    void u8(std::uint8_t value) { put<1>(value); }
+    void u32(std::uint32_t value) { put<4>(value); }
+    void i32(std::int32_t value) { put<4>(static_cast<std::uint32_t>(value)); }
+    void u64(std::uint64_t value) { put<8>(value); }
+    void name(std::string_view name) {
+        bytes.append(name);
+        bytes.push_back('\0');
+        size += name.size() + 1;
+    }
+
+    // A set takes exactly wordsPerSet words, the missing words are zeros.
+    void set(const SymbolSet &set, std::size_t wordsPerSet) {
+        auto &words = set.words();
+        for (std::size_t i = 0; i < wordsPerSet; ++i) { u64(i < words.size() ? words[i] : 0); }
+    }
+
+    template <int width>
+    void put(std::uint64_t value) {
+        char data[width];
+        for (int i = 0; i < width; ++i) { data[i] = static_cast<char>(value >> (8 * i)); }
+        bytes.append(data, width);
+        ++size;
+    }
+};
+
+}    // namespace
+
+int GrammarImage::write(const LL1Analyzer &theLL1Analyzer, std::string &data) {
+    auto gc = theLL1Analyzer.grammarContext();
+    if (gc == nullptr) { return 1; }
+
+    auto &st = *gc->st;
+    auto &pl = gc->pl->table();
+    auto isAnalyzed = theLL1Analyzer.isParsed();
+    auto symbolCount = st.symbolCount();
+    auto wordsPerSet = isAnalyzed ? (symbolCount + SymbolSet::wordBits - 1) / SymbolSet::wordBits : 0;
+    std::vector<SectionData> sections(sectionCount);
+
+    // Offsets of the names and the right hand sides are 32 bits.
+    constexpr auto maxOffset = std::numeric_limits<std::uint32_t>::max();
+    auto &names = sections[nameSection];
+    for (auto symbol : st.table()) {
+        sections[nameOffsetSection].u32(static_cast<std::uint32_t>(names.size));
+        names.name(symbol->name());
+        if (names.size > maxOffset) { return 1; }
+        auto flags = static_cast<std::uint8_t>(symbol->getType());
+        if (isAnalyzed && symbol->isNillable()) { flags |= nillableFlag; }
+        sections[symbolFlagSection].u8(flags);
+    }
+    sections[nameOffsetSection].u32(static_cast<std::uint32_t>(names.size));
+
+    auto &rhsSymbols = sections[rhsSection];
+    for (auto &p : pl) {
+        sections[lhsSection].u32(static_cast<std::uint32_t>(p.lhs.symbol->id()));
+        sections[rhsOffsetSection].u32(static_cast<std::uint32_t>(rhsSymbols.size));
+        for (auto symbol : p.rhs.symbolList) { rhsSymbols.u32(static_cast<std::uint32_t>(symbol->id())); }
+        if (rhsSymbols.size > maxOffset) { return 1; }
+        sections[productionFlagSection].u8(isAnalyzed && p.rhs.isNillable ? nillableFlag : 0);
+    }
+    sections[rhsOffsetSection].u32(static_cast<std::uint32_t>(rhsSymbols.size));
+
+    std::size_t rowCount = 0;
+    std::size_t columnCount = 0;
+    if (isAnalyzed) {
+        for (auto symbol : st.table()) {
+            sections[firstSetSection].set(symbol->firstSet(), wordsPerSet);
+            sections[followSetSection].set(symbol->followSet(), wordsPerSet);
+        }
+        for (auto &p : pl) {
+            sections[rhsFirstSetSection].set(p.rhs.firstSet, wordsPerSet);
+            sections[predictSetSection].set(p.rhs.predictSet, wordsPerSet);
+        }
+
+        auto &table = theLL1Analyzer.ll1Table();
+        auto &compressed = theLL1Analyzer.compressedLL1Table();
+        rowCount = table.rowCount();
+        columnCount = table.columnCount();
+        for (auto symbol : table.nonterminals) { sections[rowSymbolSection].u32(static_cast<std::uint32_t>(symbol->id())); }
+        for (auto symbol : table.terminals) { sections[columnSymbolSection].u32(static_cast<std::uint32_t>(symbol->id())); }
+        for (std::size_t row = 0; row < rowCount; ++row) {
+            sections[baseSection].i32(compressed.base[row]);
+            sections[defaultSection].i32(compressed.defaults[row]);
+        }
+        for (std::size_t i = 0; i < compressed.entries.size(); ++i) {
+            sections[entrySection].i32(compressed.entries[i]);
+            sections[checkSection].i32(compressed.check[i]);
+        }
+        auto &conflictIds = sections[conflictIdSection];
+        for (auto &[index, ids] : table.conflicts) {
+            sections[conflictCellSection].u64(index);
+            sections[conflictOffsetSection].u32(static_cast<std::uint32_t>(conflictIds.size));
+            for (auto id : ids) { conflictIds.i32(id); }
+            if (conflictIds.size > maxOffset) { return 1; }
+        }
+    }
+    sections[conflictOffsetSection].u32(static_cast<std::uint32_t>(sections[conflictIdSection].size));
+
+    // Every section begins at an 8 bytes boundary, so the arrays are read in place.
+    auto align = [](std::uint64_t offset) { return (offset + 7) / 8 * 8; };
+    std::uint64_t offset = sizeof(Header);
+    std::vector<std::uint64_t> offsets(sectionCount);
+    for (std::size_t i = 0; i < sectionCount; ++i) {
+        offsets[i] = offset;
+        offset = align(offset + sections[i].bytes.size());
+    }
+
+    SectionData header;
+    header.bytes.append(magic, sizeof(magic));
+    header.u32(version);
+    header.u32(isAnalyzed ? analyzedFlag : 0);
+    header.u64(offset);
+    header.u64(symbolCount);
+    header.u64(pl.size());
+    header.u64(wordsPerSet);
+    header.u64(rowCount);
+    header.u64(columnCount);
+    for (std::size_t i = 0; i < sectionCount; ++i) {
+        header.u64(offsets[i]);
+        header.u64(sections[i].size);
+    }
+    assert(header.bytes.size() == sizeof(Header));
+
+    auto begin = data.size();
+    data.reserve(begin + offset);
+    data += header.bytes;
+    for (std::size_t i = 0; i < sectionCount; ++i) {
+        data.resize(begin + offsets[i], '\0');
+        data += sections[i].bytes;
+    }
+    data.resize(begin + offset, '\0');
+    return 0;
+}
+
+int GrammarImage::writeToFile(const LL1Analyzer &theLL1Analyzer, const std::string &filename) {
+    std::string data;
+    if (write(theLL1Analyzer, data) != 0) { return 1; }
+
+    // Another process may have the old image mapped, so it is replaced instead of overwritten.
+    auto temporary = filename + ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream ofs(temporary, std::ios::binary | std::ios::trunc);
+        if (!ofs || !ofs.write(data.data(), static_cast<std::streamsize>(data.size())) || !ofs.flush()) {
+            std::error_code ec;
+            fs::remove(temporary, ec);
+            return 1;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporary, filename, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return 1;
+    }
+    return 0;
+}
+
+bool GrammarImage::isImageFile(const std::string &filename) {
+    char bytes[sizeof(magic)];
+    std::ifstream ifs(filename, std::ios::binary);
+    return ifs.read(bytes, sizeof(bytes)) && std::equal(bytes, bytes + sizeof(bytes), magic);
+}
+
+int GrammarImage::open(const std::string &filename) {
+    close();
+#ifdef CSA_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) { return 1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return 1;
+    }
+    auto size = static_cast<std::size_t>(st.st_size);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) { return 1; }
+    mapping_ = mapping;
+    data_ = static_cast<const char *>(mapping);
+    size_ = size;
+    if (validate() != 0) {
+        close();
+        return 1;
+    }
+    return 0;
+#else
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    if (!ifs) { return 1; }
+    std::string data(static_cast<std::size_t>(ifs.tellg()), '\0');
+    ifs.seekg(0);
+    if (!ifs.read(data.data(), static_cast<std::streamsize>(data.size()))) { return 1; }
+    return load(data);
+#endif
+}
+
+int GrammarImage::load(std::string_view data) {
+    close();
+    if (data.size() < sizeof(Header)) { return 1; }
+    buffer_.resize((data.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    std::memcpy(buffer_.data(), data.data(), data.size());
+    data_ = reinterpret_cast<const char *>(buffer_.data());
+    size_ = data.size();
+    if (validate() != 0) {
+        close();
+        return 1;
+    }
+    return 0;
+}
+
+void GrammarImage::close() {
+#ifdef CSA_HAS_MMAP
+    if (mapping_) { munmap(mapping_, size_); }
+#endif
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+}
+
+int GrammarImage::validate() {
+    static_assert(sizeof(Header) == 64 + sectionCount * sizeof(SectionEntry));
+    if (!isLittleEndianHost() || size_ < sizeof(Header)) { return 1; }
+    auto &h = header();
+    if (!std::equal(magic, magic + sizeof(magic), h.magic) || h.version != version || h.byteSize != size_ ||
+        (h.flags & ~analyzedFlag) != 0) {
+        return 1;
+    }
+
+    // Every section must be aligned and inside the image, and have the count its header gives.
+    static constexpr std::size_t widths[sectionCount] = {4, 1, 1, 4, 4, 4, 1, 8, 8, 8, 8, 4, 4, 4, 4, 4, 4, 8, 4, 4};
+    for (std::size_t i = 0; i < sectionCount; ++i) {
+        auto &entry = h.sections[i];
+        if (entry.offset % 8 != 0 || entry.offset < sizeof(Header) || entry.offset > size_ ||
+            entry.size > (size_ - entry.offset) / widths[i]) {
+            return 1;
+        }
+    }
+    // The counts are not more than the bytes of their sections, so the products below don't overflow.
+    auto symbolCount = h.sections[symbolFlagSection].size;
+    auto productionCount = h.sections[productionFlagSection].size;
+    auto isAnalyzed = this->isAnalyzed();
+    auto wordsPerSet = isAnalyzed ? (symbolCount + SymbolSet::wordBits - 1) / SymbolSet::wordBits : 0;
+    auto isCount = [&](Section id, std::uint64_t size) { return h.sections[id].size == size; };
+    if (h.symbolCount != symbolCount || symbolCount == 0 || h.productionCount != productionCount ||
+        productionCount == 0 || h.wordsPerSet != wordsPerSet || !isCount(nameOffsetSection, symbolCount + 1) ||
+        !isCount(lhsSection, productionCount) || !isCount(rhsOffsetSection, productionCount + 1) ||
+        !isCount(firstSetSection, symbolCount * wordsPerSet) || !isCount(followSetSection, symbolCount * wordsPerSet) ||
+        !isCount(rhsFirstSetSection, productionCount * wordsPerSet) ||
+        !isCount(predictSetSection, productionCount * wordsPerSet) || !isCount(rowSymbolSection, h.rowCount) ||
+        !isCount(columnSymbolSection, h.columnCount) || !isCount(baseSection, h.rowCount) ||
+        !isCount(defaultSection, h.rowCount) || !isCount(checkSection, h.sections[entrySection].size) ||
+        !isCount(conflictOffsetSection, h.sections[conflictCellSection].size + 1) ||
+        (!isAnalyzed && (h.rowCount != 0 || h.columnCount != 0 || h.sections[entrySection].size != 0 ||
+                         h.sections[conflictCellSection].size != 0))) {
+        return 1;
+    }
+
+    // A CSR offset array begins at 0, never goes back, and ends at the size of its data.
+    auto isOffsets = [](Array<std::uint32_t> offsets, std::uint64_t size) {
+        if (offsets[0] != 0 || offsets[offsets.size() - 1] != size) { return false; }
+        for (std::size_t i = 1; i < offsets.size(); ++i) {
+            if (offsets[i] < offsets[i - 1]) { return false; }
+        }
+        return true;
+    };
+
+    // Every name is not empty, and it has only one NUL at its end.
+    auto nameOffsets = section<std::uint32_t>(nameOffsetSection);
+    auto names = section<char>(nameSection);
+    if (!isOffsets(nameOffsets, names.size())) { return 1; }
+    for (std::size_t id = 0; id < symbolCount; ++id) {
+        auto size = nameOffsets[id + 1] - nameOffsets[id];
+        if (size < 2 || std::memchr(names.begin() + nameOffsets[id], '\0', size) != names.begin() + nameOffsets[id + 1] - 1) {
+            return 1;
+        }
+    }
+    auto symbolFlags = section<std::uint8_t>(symbolFlagSection);
+    for (auto flags : symbolFlags) {
+        if ((flags & ~(typeMask | nillableFlag)) != 0 ||
+            (flags & typeMask) > static_cast<std::uint8_t>(Symbol::Type::terminalIsEpsilon)) {
+            return 1;
+        }
+    }
+    auto isTerminal = [&](std::uint64_t id) {
+        return (symbolFlags[id] & typeMask) > static_cast<std::uint8_t>(Symbol::Type::nonterminal);
+    };
+
+    auto rhsSymbols = section<std::uint32_t>(rhsSection);
+    if (!isOffsets(section<std::uint32_t>(rhsOffsetSection), rhsSymbols.size())) { return 1; }
+    for (auto id : section<std::uint32_t>(lhsSection)) {
+        if (id >= symbolCount || isTerminal(id)) { return 1; }
+    }
+    for (auto id : rhsSymbols) {
+        if (id >= symbolCount) { return 1; }
+    }
+    for (auto flags : section<std::uint8_t>(productionFlagSection)) {
+        if ((flags & ~nillableFlag) != 0) { return 1; }
+    }
+    if (!isAnalyzed) { return 0; }
+
+    // The set sections are not read here, so opening an image doesn't touch most of its pages.
+    std::vector<bool> isUsed(symbolCount, false);
+    for (auto id : section<std::uint32_t>(rowSymbolSection)) {
+        if (id >= symbolCount || isTerminal(id) || isUsed[id]) { return 1; }
+        isUsed[id] = true;
+    }
+    for (auto id : section<std::uint32_t>(columnSymbolSection)) {
+        if (id >= symbolCount || !isTerminal(id) || isUsed[id]) { return 1; }
+        isUsed[id] = true;
+    }
+    auto isCell = [&](Cell cell) {
+        return cell >= LL1Table::conflictCell && static_cast<std::int64_t>(cell) < static_cast<std::int64_t>(productionCount);
+    };
+    for (auto base : section<std::int32_t>(baseSection)) {
+        if (base < 0) { return 1; }
+    }
+    for (auto cell : section<Cell>(defaultSection)) {
+        if (!isCell(cell)) { return 1; }
+    }
+    for (auto cell : section<Cell>(entrySection)) {
+        if (!isCell(cell)) { return 1; }
+    }
+    for (auto row : section<std::int32_t>(checkSection)) {
+        if (row < CompressedLL1Table::noRow || static_cast<std::int64_t>(row) >= static_cast<std::int64_t>(h.rowCount)) {
+            return 1;
+        }
+    }
+
+    // Conflict cells are sorted cell indexes, productionsAt() finds them by binary search.
+    auto conflictIds = section<std::int32_t>(conflictIdSection);
+    if (!isOffsets(section<std::uint32_t>(conflictOffsetSection), conflictIds.size())) { return 1; }
+    auto conflictCells = section<std::uint64_t>(conflictCellSection);
+    for (std::size_t i = 0; i < conflictCells.size(); ++i) {
+        if ((i > 0 && conflictCells[i] <= conflictCells[i - 1]) || conflictCells[i] >= h.rowCount * h.columnCount) {
+            return 1;
+        }
+    }
+    for (auto id : conflictIds) {
+        if (id < 0 || static_cast<std::uint64_t>(id) >= productionCount) { return 1; }
+    }
+    return 0;
+}
+
+GrammarImage::Cell GrammarImage::cellAt(std::size_t row, std::size_t column) const {
+    auto check = section<std::int32_t>(checkSection);
+    auto index = static_cast<std::size_t>(section<std::int32_t>(baseSection)[row]) + column;
+    return index < check.size() && check[index] == static_cast<std::int32_t>(row) ? section<Cell>(entrySection)[index]
+                                                                                   : section<Cell>(defaultSection)[row];
+}
+
+std::vector<int> GrammarImage::productionsAt(std::size_t row, std::size_t column) const {
+    auto cell = cellAt(row, column);
+    if (cell == LL1Table::emptyCell) { return {}; }
+    if (cell != LL1Table::conflictCell) { return {cell}; }
+
+    auto conflictCells = section<std::uint64_t>(conflictCellSection);
+    auto index = static_cast<std::uint64_t>(row) * columnCount() + column;
+    auto found = std::lower_bound(conflictCells.begin(), conflictCells.end(), index);
+    if (found == conflictCells.end() || *found != index) { return {}; }
+    auto i = static_cast<std::size_t>(found - conflictCells.begin());
+    auto offsets = section<std::uint32_t>(conflictOffsetSection);
+    auto ids = section<std::int32_t>(conflictIdSection);
+    return std::vector<int>(ids.begin() + offsets[i], ids.begin() + offsets[i + 1]);
+}
+
+GrammarContextPtr GrammarContextBuilder::buildFromImage(const GrammarImage &image) {
+    if (!image.isOpen()) { return {}; }
+
+    // Symbols are created in id order, so they take the same ids as the image's.
+    // The alien symbol is the first one of every symbol table, it is not found by its name.
+    auto st = std::make_shared<SymbolTable>();
+    for (std::size_t id = 0; id < image.symbolCount(); ++id) {
+        auto symbol = id == 0 ? st->getAlienSymbol() : st->findSymbol(image.symbolName(id));
+        if (symbol->name() != image.symbolName(id)) { return {}; }
+        if (symbol->id() != id) { return {}; }
+        symbol->setType(image.symbolType(id));
+    }
+
+    ProductionList pl(image.productionCount());
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        auto &p = pl[i];
+        p.id = static_cast<int>(i);
+        p.lhs.symbol = st->getSymbol(image.lhsOf(i));
+        auto rhs = image.rhsOf(i);
+        p.rhs.symbolList.reserve(rhs.size());
+        for (auto id : rhs) { p.rhs.symbolList.push_back(st->getSymbol(id)); }
+    }
+    auto pt = std::make_shared<ProductionTable>(pl);
+    return std::make_shared<GrammarContext>(pt, st);
+}
+
+int LL1Analyzer::loadAnalysis(const GrammarImage &image) {
+    if (gc_ == nullptr || !image.isOpen() || !image.isAnalyzed()) { return 1; }
+
+    // The image must be of the same grammar context.
+    auto &st = *gc_->st;
+    auto &pl = gc_->pl->table();
+    auto symbolCount = st.symbolCount();
+    if (image.symbolCount() != symbolCount || image.productionCount() != pl.size()) { return 1; }
+    for (std::size_t id = 0; id < symbolCount; ++id) {
+        if (image.symbolType(id) != st.getType(id) || image.symbolName(id) != st.getSymbol(id)->name()) { return 1; }
+    }
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        auto rhs = image.rhsOf(i);
+        if (image.lhsOf(i) != pl[i].lhs.symbol->id() || rhs.size() != pl[i].rhs.symbolList.size() ||
+            !std::equal(rhs.begin(), rhs.end(), pl[i].rhs.symbolList.begin(),
+                        [](std::uint32_t id, SymbolPtr symbol) { return id == symbol->id(); })) {
+            return 1;
+        }
+    }
+
+    // The image is validated when it is opened, so only the conflicts are checked here.
+    LoadedAnalysis analysis;
+    auto &table = analysis.table;
+    auto &compressed = analysis.compressed;
+    auto rowCount = image.rowCount();
+    auto columnCount = image.columnCount();
+    table.rowOfSymbol.assign(symbolCount, LL1Table::npos);
+    table.columnOfSymbol.assign(symbolCount, LL1Table::npos);
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        table.nonterminals.push_back(st.getSymbol(image.rowSymbol(row)));
+        table.rowOfSymbol[image.rowSymbol(row)] = row;
+    }
+    for (std::size_t column = 0; column < columnCount; ++column) {
+        table.terminals.push_back(st.getSymbol(image.columnSymbol(column)));
+        table.columnOfSymbol[image.columnSymbol(column)] = column;
+    }
+    auto base = image.section<std::int32_t>(GrammarImage::baseSection);
+    auto defaults = image.section<LL1Table::Cell>(GrammarImage::defaultSection);
+    auto entries = image.section<LL1Table::Cell>(GrammarImage::entrySection);
+    auto check = image.section<std::int32_t>(GrammarImage::checkSection);
+    compressed.rowCount = rowCount;
+    compressed.columnCount = columnCount;
+    compressed.base.assign(base.begin(), base.end());
+    compressed.defaults.assign(defaults.begin(), defaults.end());
+    compressed.entries.assign(entries.begin(), entries.end());
+    compressed.check.assign(check.begin(), check.end());
+
+    // Every conflict cell of the table has its production ids.
+    analysis.rhsList.resize(pl.size());
+    auto conflictCells = image.section<std::uint64_t>(GrammarImage::conflictCellSection);
+    if (conflictCells.size() != expandLL1Table(analysis)) { return 1; }
+    auto conflictOffsets = image.section<std::uint32_t>(GrammarImage::conflictOffsetSection);
+    auto conflictIds = image.section<std::int32_t>(GrammarImage::conflictIdSection);
+    for (std::size_t i = 0; i < conflictCells.size(); ++i) {
+        std::vector<int> ids(conflictIds.begin() + conflictOffsets[i], conflictIds.begin() + conflictOffsets[i + 1]);
+        if (!addConflict(analysis, static_cast<std::size_t>(conflictCells[i]), std::move(ids))) { return 1; }
+    }
+
+    // The sets are copied without the bits over the last symbol id and the zero words at the end,
+    // so iterating them gives valid ids only.
+    auto tailBits = symbolCount % SymbolSet::wordBits;
+    auto toSet = [tailBits](GrammarImage::Array<GrammarImage::Word> words) {
+        std::vector<SymbolSet::Word> copy(words.begin(), words.end());
+        if (tailBits != 0 && !copy.empty()) { copy.back() &= ~(~SymbolSet::Word(0) << tailBits); }
+        while (!copy.empty() && copy.back() == 0) { copy.pop_back(); }
+        SymbolSet set;
+        set.setWords(std::move(copy));
+        return set;
+    };
+    analysis.symbols.resize(symbolCount);
+    for (std::size_t id = 0; id < symbolCount; ++id) {
+        analysis.symbols[id].isNillable = image.isNillable(id);
+        analysis.symbols[id].firstSet = toSet(image.firstSet(id));
+        analysis.symbols[id].followSet = toSet(image.followSet(id));
+    }
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        analysis.rhsList[i].isNillable = image.isRhsNillable(i);
+        analysis.rhsList[i].firstSet = toSet(image.rhsFirstSet(i));
+        analysis.rhsList[i].predictSet = toSet(image.predictSet(i));
+    }
+    restoreAnalysis(analysis);
+    return 0;
+}
@@ -0,0 +1,231 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "LL1Analyzer.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace csa {
+
+/**
+ * @brief A read-only binary image of an analyzed grammar.
+ *
+ * An image holds the grammar context and the LL(1) analysis results in flat arrays, so it is
+ * used in place: a file is memory mapped and every accessor reads the mapping, nothing is
+ * parsed or copied when it is opened. All the numbers are little endian, and every section
+ * is addressed by its offset from the beginning of the image, so there are no pointers.
+ *
+ *     header      magic, version, counts, and the offset and length of every section
+ *     symbols     name offsets into one NUL-terminated name blob, a flag byte per symbol
+ *                 (type and nillable, the same bits as SymbolTable)
+ *     productions left hand side ids, right hand side offsets into one id array(CSR)
+ *     sets        bitsets of wordsPerSet words: first and follow sets per symbol,
+ *                 first and predict sets of the right hand side per production
+ *     table       row and column symbols, the row displacement compressed LL(1) table,
+ *                 conflict cells with their production ids(CSR)
+ *
+ * The structure is validated when it is opened, so the accessors don't check again, their ids
+ * must be in range. The set sections are not read when it is opened, their bits over the last
+ * symbol id are ignored. An image of a grammar which is not analyzed has empty sets and table
+ * sections.
+ */
+class GrammarImage {
+public:
+    using Word = SymbolSet::Word;
+    using Cell = LL1Table::Cell;
+    static constexpr std::uint32_t version = 1;
+    static constexpr std::uint8_t typeMask = 0x07;        ///< Symbol flag bits of the type.
+    static constexpr std::uint8_t nillableFlag = 0x08;    ///< Symbol and production flag bit of nillable.
+
+    /**
+     * @brief A view of a section array.
+     */
+    template <typename T>
+    class Array {
+    public:
+        Array() = default;
+        Array(const T *data, std::size_t size) : data_(data), size_(size) {}
+        const T *begin() const { return data_; }
+        const T *end() const { return data_ + size_; }
+        const T &operator[](std::size_t index) const { return data_[index]; }
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+    private:
+        const T *data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    GrammarImage() = default;
+    ~GrammarImage() { close(); }
+    GrammarImage(const GrammarImage &) = delete;
+    GrammarImage &operator=(const GrammarImage &) = delete;
+
+    /**
+     * @brief Write the image of an analyzer's grammar, with its results if it is parsed.
+     *
+     * @param[out] data     The image is appended to it.
+     * @return int          0 if pass.
+     */
+    static int write(const LL1Analyzer &theLL1Analyzer, std::string &data);
+
+    /**
+     * @brief Write the image to a file, it is written to a temporary file then renamed.
+     *
+     * @return int          0 if pass.
+     */
+    static int writeToFile(const LL1Analyzer &theLL1Analyzer, const std::string &filename);
+
+    /**
+     * @brief Check whether a file begins with the magic of an image.
+     */
+    static bool isImageFile(const std::string &filename);
+
+    /**
+     * @brief Open an image file, it is memory mapped if the platform supports it.
+     *
+     * @return int          0 if pass, or the file is not a valid image of this version.
+     */
+    int open(const std::string &filename);
+
+    /**
+     * @brief Load an image in memory, it is copied into an aligned buffer.
+     *
+     * @return int          0 if pass, or the data is not a valid image of this version.
+     */
+    int load(std::string_view data);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+    bool isAnalyzed() const { return header().flags & analyzedFlag; }
+    std::size_t byteSize() const { return size_; }
+
+    //
+    // Grammar context.
+    //
+    std::size_t symbolCount() const { return static_cast<std::size_t>(header().symbolCount); }
+    std::string_view symbolName(SymbolId id) const {
+        auto offsets = section<std::uint32_t>(nameOffsetSection);
+        return std::string_view(section<char>(nameSection).begin() + offsets[id], offsets[id + 1] - offsets[id] - 1);
+    }
+    Symbol::Type symbolType(SymbolId id) const {
+        return static_cast<Symbol::Type>(section<std::uint8_t>(symbolFlagSection)[id] & typeMask);
+    }
+    std::size_t productionCount() const { return static_cast<std::size_t>(header().productionCount); }
+    SymbolId lhsOf(std::size_t production) const { return section<std::uint32_t>(lhsSection)[production]; }
+    Array<std::uint32_t> rhsOf(std::size_t production) const {
+        auto offsets = section<std::uint32_t>(rhsOffsetSection);
+        return Array<std::uint32_t>(section<std::uint32_t>(rhsSection).begin() + offsets[production],
+                                    offsets[production + 1] - offsets[production]);
+    }
+
+    //
+    // Analysis results, they are empty if the image is not analyzed.
+    //
+    bool isNillable(SymbolId id) const { return section<std::uint8_t>(symbolFlagSection)[id] & nillableFlag; }
+    bool isRhsNillable(std::size_t production) const {
+        return section<std::uint8_t>(productionFlagSection)[production] & nillableFlag;
+    }
+    Array<Word> firstSet(SymbolId id) const { return setOf(firstSetSection, id); }
+    Array<Word> followSet(SymbolId id) const { return setOf(followSetSection, id); }
+    Array<Word> rhsFirstSet(std::size_t production) const { return setOf(rhsFirstSetSection, production); }
+    Array<Word> predictSet(std::size_t production) const { return setOf(predictSetSection, production); }
+    static bool contains(Array<Word> set, SymbolId id) {
+        auto index = id / SymbolSet::wordBits;
+        return index < set.size() && (set[index] >> (id % SymbolSet::wordBits)) & 1;
+    }
+
+    //
+    // LL(1) table, rows and columns are in the same order as LL1Table.
+    //
+    std::size_t rowCount() const { return static_cast<std::size_t>(header().rowCount); }
+    std::size_t columnCount() const { return static_cast<std::size_t>(header().columnCount); }
+    SymbolId rowSymbol(std::size_t row) const { return section<std::uint32_t>(rowSymbolSection)[row]; }
+    SymbolId columnSymbol(std::size_t column) const { return section<std::uint32_t>(columnSymbolSection)[column]; }
+
+    /**
+     * @brief Get a cell of the LL(1) table by the compressed table, it is O(1).
+     *
+     * @return Cell     A production id, LL1Table::emptyCell or LL1Table::conflictCell.
+     */
+    Cell cellAt(std::size_t row, std::size_t column) const;
+
+    /**
+     * @brief Get all the production ids of a cell, they are sorted.
+     */
+    std::vector<int> productionsAt(std::size_t row, std::size_t column) const;
+
+private:
+    friend class LL1Analyzer;
+
+    enum Section : std::uint32_t {
+        nameOffsetSection = 0,    ///< u32 x (symbols + 1), offsets into the name blob.
+        nameSection,              ///< char x blob size, every name ends with NUL.
+        symbolFlagSection,        ///< u8 x symbols, type and nillable.
+        lhsSection,               ///< u32 x productions.
+        rhsOffsetSection,         ///< u32 x (productions + 1), offsets into the rhs ids.
+        rhsSection,               ///< u32 x rhs symbols.
+        productionFlagSection,    ///< u8 x productions, nillable.
+        firstSetSection,          ///< u64 x symbols x wordsPerSet.
+        followSetSection,         ///< u64 x symbols x wordsPerSet.
+        rhsFirstSetSection,       ///< u64 x productions x wordsPerSet.
+        predictSetSection,        ///< u64 x productions x wordsPerSet.
+        rowSymbolSection,         ///< u32 x rows.
+        columnSymbolSection,      ///< u32 x columns.
+        baseSection,              ///< i32 x rows, displacements of the compressed table.
+        defaultSection,           ///< i32 x rows, default cells of the compressed table.
+        entrySection,             ///< i32 x entries, packed cells of the compressed table.
+        checkSection,             ///< i32 x entries, owner rows of the packed cells.
+        conflictCellSection,      ///< u64 x conflicts, sorted dense cell indexes.
+        conflictOffsetSection,    ///< u32 x (conflicts + 1), offsets into the conflict ids.
+        conflictIdSection,        ///< i32 x conflict ids.
+        sectionCount
+    };
+
+    struct SectionEntry {
+        std::uint64_t offset;    ///< Offset from the beginning of the image, 8 bytes aligned.
+        std::uint64_t size;      ///< Count of the elements.
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::uint64_t byteSize;
+        std::uint64_t symbolCount;
+        std::uint64_t productionCount;
+        std::uint64_t wordsPerSet;
+        std::uint64_t rowCount;
+        std::uint64_t columnCount;
+        SectionEntry sections[sectionCount];
+    };
+    static constexpr std::uint32_t analyzedFlag = 1;
+
+    int validate();
+    const Header &header() const { return *reinterpret_cast<const Header *>(data_); }
+    template <typename T>
+    Array<T> section(Section id) const {
+        auto &entry = header().sections[id];
+        return Array<T>(reinterpret_cast<const T *>(data_ + entry.offset), static_cast<std::size_t>(entry.size));
+    }
+    Array<Word> setOf(Section id, std::size_t index) const {
+        auto wordsPerSet = static_cast<std::size_t>(header().wordsPerSet);
+        return Array<Word>(section<Word>(id).begin() + index * wordsPerSet, wordsPerSet);
+    }
+
+    const char *data_ = nullptr;     ///< The image, it is 8 bytes aligned.
+    std::size_t size_ = 0;
+    void *mapping_ = nullptr;        ///< The memory mapping, or nullptr if the image is in buffer_.
+    std::vector<std::uint64_t> buffer_;
+};
+
+}    // namespace csa
@@ -0,0 +1,142 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LALRAnalyzer.h"
+#include "Digraph.h"
+#include "LL1Analyzer.h"
+
+using namespace csa;
+
+int LALRAnalyzer::parse() {
+    if (gc_ == nullptr || gc_->pl->table().empty()) { return 1; }
+    if (isParsed_) { return 0; }
+
+    // Nullable symbols and suffixes.
+    LL1Analyzer theLL1Analyzer(gc_);
+    if (theLL1Analyzer.parse() != 0) { return 1; }
+
+    sf_ = LR0Analyzer::buildStateFamily(gc_, jobs_);
+    buildLookaheads();
+    LR0Analyzer::buildLRxTable(*sf_, lrxTable_, &lookaheads_);
+    isParsed_ = true;
+
+    return 0;
+}
+
+void LALRAnalyzer::buildLookaheads() {
+    using StatePtr = LRxStateFamily::StatePtr;
+    constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    auto &states = sf_->stateTable();
+    auto &pl = gc_->pl->table();
+    statistics_ = {};
+
+    // Number the nonterminal transitions, they are the nodes of the relations.
+    struct Node {
+        StatePtr state;     ///< From state p.
+        SymbolId symbol;    ///< Nonterminal A.
+        StatePtr target;    ///< Goto state of (p, A).
+    };
+    std::vector<Node> nodes;
+    std::vector<std::size_t> transitionBase(states.size());    ///< State id mapping its first transition.
+    std::vector<std::size_t> nodeOfTransition;                 ///< Transition mapping its node, or npos.
+    for (auto state : states) {
+        transitionBase[state->id] = nodeOfTransition.size();
+        for (auto &[symbol, target] : state->transitions) {
+            if (gc_->st->getSymbol(symbol)->isNonterminal()) {
+                nodeOfTransition.push_back(nodes.size());
+                nodes.push_back({state, symbol, target});
+            } else {
+                nodeOfTransition.push_back(npos);
+            }
+        }
+    }
+    auto nodeOf = [&](StatePtr state, SymbolId symbol) {
+        auto &transitions = state->transitions;
+        auto it = std::lower_bound(transitions.begin(), transitions.end(), symbol,
+                                   [](const auto &transition, SymbolId id) { return transition.first < id; });
+        return nodeOfTransition[transitionBase[state->id] + (it - transitions.begin())];
+    };
+
+    // Read(p, A) only depends on the goto state r of (p, A), it is the terminals shifted in r,
+    // plus Read(r, C) of every nullable C. So reads is solved on states, its edges are
+    // the nullable gotos, instead of every pair of (p, A) reads (r, C).
+    std::vector<SymbolSet> shifts(states.size());
+    Relation reads(states.size());
+    for (auto state : states) {
+        for (auto &[symbol, target] : state->transitions) {
+            auto theSymbol = gc_->st->getSymbol(symbol);
+            if (theSymbol->isTerminal()) {
+                shifts[state->id].insert(symbol);
+            } else if (theSymbol->isNillable()) {
+                reads[state->id].push_back(static_cast<std::size_t>(target->id));
+            }
+        }
+        statistics_.readsCount += reads[state->id].size();
+    }
+    digraph(reads, shifts);
+
+    std::vector<SymbolSet> sets(nodes.size());
+    for (std::size_t x = 0; x < nodes.size(); ++x) { sets[x] = shifts[nodes[x].target->id]; }
+
+    // Walk every production from every goto on its left hand side, for includes and lookback.
+    std::vector<std::vector<const Production *>> productionsOf(gc_->st->symbolCount());
+    for (auto &p : pl) { productionsOf[p.lhs.symbol->id()].push_back(&p); }
+
+    struct Lookback {
+        StatePtr state;              ///< State q of the complete item.
+        std::size_t reduction;       ///< Index in the state's reductions.
+        std::size_t node;            ///< Node (p, A).
+    };
+    std::vector<Lookback> lookbacks;
+    Relation includes(nodes.size());
+    for (std::size_t x = 0; x < nodes.size(); ++x) {
+        for (auto p : productionsOf[nodes[x].symbol]) {
+            auto &symbolList = p->rhs.symbolList;
+            auto length = symbolList.size() == 1 && symbolList.front()->isTerminalEpsilon() ? 0 : symbolList.size();
+            auto state = nodes[x].state;
+            for (std::size_t i = 0; i < length; ++i) {
+                auto symbol = symbolList[i];
+                if (symbol->isNonterminal() && p->rhs.suffixList[i + 1].isNillable) {
+                    includes[nodeOf(state, symbol->id())].push_back(x);
+                    ++statistics_.includesCount;
+                }
+                state = state->gotoState(symbol->id());
+            }
+
+            auto &reductions = state->reductions;
+            auto it = std::lower_bound(reductions.begin(), reductions.end(), p->id);
+            lookbacks.push_back({state, static_cast<std::size_t>(it - reductions.begin()), x});
+        }
+    }
+    digraph(includes, sets);
+
+    lookaheads_.assign(states.size(), {});
+    for (auto state : states) { lookaheads_[state->id].resize(state->reductions.size()); }
+    for (auto &lookback : lookbacks) { lookaheads_[lookback.state->id][lookback.reduction].unite(sets[lookback.node]); }
+
+    statistics_.nonterminalTransitionCount = nodes.size();
+    statistics_.lookbackCount = lookbacks.size();
+}
+
+bool LALRAnalyzer::isValidLALR() {
+    if (!isParsed_) { return false; }
+
+    bool good = true;
+    if (lrxTable_.hasConflict()) {
+        auto cell = lrxTable_.conflicts.front().cell;
+        printf("[LALRAnalyzer::isValidLALR]\n");
+        printf("  [note] state(id=%zu) has conflict actions on symbol [%s], ", lrxTable_.rowOf(cell),
+               lrxTable_.symbolOf(cell)->name().data());
+        printf("it's invalid LALR grammar.\n");
+        good = false;
+    }
+
+    return good;
+}
@@ -0,0 +1,73 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+#include "LR0Analyzer.h"
+
+namespace csa {
+
+/**
+ * @brief Build the LALR(1) table of a grammar from its LR(0) states.
+ *
+ * Lookaheads are computed by DeRemer and Pennello's relations over the nonterminal transitions:
+ *
+ *     Read(p, A)     = DR(p, A) + { Read(r, C)  | (p, A) reads (r, C) }
+ *     Follow(p, A)   = Read(p, A) + { Follow(p', B) | (p, A) includes (p', B) }
+ *     LA(q, A -> w)  = { Follow(p, A) | (q, A -> w) lookback (p, A) }
+ *
+ * Both closures are solved by the digraph algorithm, nullable comes from LL1Analyzer.
+ */
+class LALRAnalyzer {
+public:
+    LALRAnalyzer(GrammarContextPtr gc) : gc_(gc), isParsed_(false) {}
+    void setJobs(std::size_t jobs) { jobs_ = jobs; }
+    int parse();
+    bool isValidLALR();
+
+    /**
+     * @brief Get the LR(0) states, they are built by parse().
+     */
+    LRxStateFamilyPtr stateFamily() const { return sf_; }
+
+    /**
+     * @brief Get the lookaheads of every state's reductions, they are built by parse().
+     */
+    const LR0Analyzer::Lookaheads &lookaheads() const { return lookaheads_; }
+
+    /**
+     * @brief Get the LALR(1) table, it is built by parse().
+     */
+    const LRxTable &lrxTable() const { return lrxTable_; }
+
+    /**
+     * @brief Sizes of the relations, they are used to measure the analysis.
+     */
+    struct Statistics {
+        std::size_t nonterminalTransitionCount = 0;    ///< Nodes of the relations.
+        std::size_t readsCount = 0;                    ///< Edges of the reads relation on goto states.
+        std::size_t includesCount = 0;                 ///< Edges of the includes relation.
+        std::size_t lookbackCount = 0;                 ///< Edges of the lookback relation.
+    };
+    const Statistics &statistics() const { return statistics_; }
+
+private:
+    void buildLookaheads();
+
+    GrammarContextPtr gc_;
+    bool isParsed_;
+    std::size_t jobs_ = 1;
+    LRxStateFamilyPtr sf_;
+    LR0Analyzer::Lookaheads lookaheads_;
+    LRxTable lrxTable_;
+    Statistics statistics_;
+};
+
+}    // namespace csa
@@ -0,0 +1,451 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LL1AnalysisCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace csa;
+namespace fs = std::filesystem;
+
+namespace {
+
+//
+// All the numbers are written in little endian, whatever the host is.
+//
+class Writer {
+public:
+    explicit Writer(std::string &data) : data_(data) {}
+
+    void u8(std::uint8_t value) { data_.push_back(static_cast<char>(value)); }
+    void u32(std::uint32_t value) { put<4>(value); }
+    void u64(std::uint64_t value) { put<8>(value); }
+    void i32(std::int32_t value) { u32(static_cast<std::uint32_t>(value)); }
+    void bytes(std::string_view bytes) {
+        u64(bytes.size());
+        data_.append(bytes);
+    }
+
+    // A set is written as its ids or its words(without the zero words at the end), which is smaller.
+    // The lowest bit of the count tells which one it is.
+    void set(const SymbolSet &set) {
+        auto &words = set.words();
+        auto wordCount = words.size();
+        while (wordCount > 0 && words[wordCount - 1] == 0) { --wordCount; }
+        auto idCount = set.size();
+        if (idCount * 4 < wordCount * 8) {
+            u32(static_cast<std::uint32_t>(idCount << 1 | 1));
+            for (auto id : set) { u32(static_cast<std::uint32_t>(id)); }
+        } else {
+            u32(static_cast<std::uint32_t>(wordCount << 1));
+            for (std::size_t i = 0; i < wordCount; ++i) { u64(words[i]); }
+        }
+    }
+
+private:
+    template <int size>
+    void put(std::uint64_t value) {
+        char bytes[size];
+        for (int i = 0; i < size; ++i) { bytes[i] = static_cast<char>(value >> (8 * i)); }
+        data_.append(bytes, size);
+    }
+
+    std::string &data_;
+};
+
+//
+// A reader never reads over the end, it turns bad and gives zeros instead.
+//
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    bool good() const { return good_; }
+    bool atEnd() const { return pos_ == data_.size(); }
+    void fail() { good_ = false; }
+
+    std::uint8_t u8() {
+        if (!has(1)) { return 0; }
+        return static_cast<std::uint8_t>(data_[pos_++]);
+    }
+    std::uint32_t u32() { return static_cast<std::uint32_t>(get<4>()); }
+    std::uint64_t u64() { return get<8>(); }
+    std::int32_t i32() { return static_cast<std::int32_t>(u32()); }
+    std::string_view bytes() {
+        auto size = u64();
+        if (!has(size)) { return {}; }
+        auto bytes = data_.substr(pos_, size);
+        pos_ += size;
+        return bytes;
+    }
+    std::string_view rest() {
+        auto bytes = data_.substr(pos_);
+        pos_ = data_.size();
+        return bytes;
+    }
+
+    // A set can't hold the ids not less than the symbol count.
+    SymbolSet set(std::size_t symbolCount) {
+        SymbolSet set;
+        auto header = u32();
+        auto count = header >> 1;
+        if (header & 1) {
+            if (count > symbolCount || !has(count * 4ull)) {
+                fail();
+                return set;
+            }
+            for (std::uint32_t i = 0; i < count; ++i) {
+                auto id = u32();
+                if (id >= symbolCount) {
+                    fail();
+                    return set;
+                }
+                set.insert(id);
+            }
+        } else {
+            if (count > (symbolCount + SymbolSet::wordBits - 1) / SymbolSet::wordBits || !has(count * 8ull)) {
+                fail();
+                return set;
+            }
+            std::vector<SymbolSet::Word> words(count);
+            for (auto &word : words) { word = u64(); }
+            set.setWords(std::move(words));
+        }
+        return set;
+    }
+
+private:
+    template <int size>
+    std::uint64_t get() {
+        if (!has(size)) { return 0; }
+        std::uint64_t value = 0;
+        for (int i = 0; i < size; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+        }
+        pos_ += size;
+        return value;
+    }
+
+    bool has(std::uint64_t size) {
+        if (good_ && size > data_.size() - pos_) { good_ = false; }
+        return good_;
+    }
+
+    std::string_view data_;
+    std::size_t pos_ = 0;
+    bool good_ = true;
+};
+
+constexpr char magic[4] = {'C', 'S', 'A', 'C'};
+constexpr std::uint32_t version = 1;
+
+// FNV-1a, the entries are verified by their keys, so it only needs to spread well.
+std::uint64_t hashOf(std::string_view bytes) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (auto c : bytes) { hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL; }
+    return hash;
+}
+
+}    // namespace
+
+int LL1Analyzer::saveAnalysis(std::string &data) const {
+    if (!isParsed_) { return 1; }
+
+    Writer out(data);
+    auto &symbols = gc_->st->table();
+    auto &pl = gc_->pl->table();
+    out.u64(symbols.size());
+    out.u64(pl.size());
+    for (auto symbol : symbols) {
+        out.u8(symbol->isNillable() ? 1 : 0);
+        out.set(symbol->firstSet());
+        out.set(symbol->followSet());
+    }
+    for (auto &p : pl) {
+        out.u8(p.rhs.isNillable ? 1 : 0);
+        out.set(p.rhs.firstSet);
+        out.set(p.rhs.predictSet);
+    }
+
+    // The dense cells are given back by the compressed table, so only it is written.
+    auto &table = ll1Table_;
+    auto &compressed = compressedLL1Table_;
+    out.u32(static_cast<std::uint32_t>(table.rowCount()));
+    out.u32(static_cast<std::uint32_t>(table.columnCount()));
+    for (auto symbol : table.nonterminals) { out.u32(static_cast<std::uint32_t>(symbol->id())); }
+    for (auto symbol : table.terminals) { out.u32(static_cast<std::uint32_t>(symbol->id())); }
+    for (std::size_t row = 0; row < table.rowCount(); ++row) {
+        out.i32(compressed.base[row]);
+        out.i32(compressed.defaults[row]);
+    }
+    out.u32(static_cast<std::uint32_t>(compressed.entries.size()));
+    for (std::size_t i = 0; i < compressed.entries.size(); ++i) {
+        out.i32(compressed.entries[i]);
+        out.i32(compressed.check[i]);
+    }
+    out.u32(static_cast<std::uint32_t>(table.conflicts.size()));
+    for (auto &[index, ids] : table.conflicts) {
+        out.u64(index);
+        out.u32(static_cast<std::uint32_t>(ids.size()));
+        for (auto id : ids) { out.i32(id); }
+    }
+    return 0;
+}
+
+int LL1Analyzer::loadAnalysis(std::string_view data) {
+    if (gc_ == nullptr) { return 1; }
+
+    auto &st = *gc_->st;
+    auto &pl = gc_->pl->table();
+    auto symbolCount = st.symbolCount();
+    auto productionCount = static_cast<LL1Table::Cell>(pl.size());
+    Reader in(data);
+    if (in.u64() != symbolCount || in.u64() != pl.size()) { return 1; }
+
+    // Read all into new objects first, so a broken data changes nothing.
+    LoadedAnalysis analysis;
+    analysis.symbols.resize(symbolCount);
+    for (auto &symbol : analysis.symbols) {
+        symbol.isNillable = in.u8() != 0;
+        symbol.firstSet = in.set(symbolCount);
+        symbol.followSet = in.set(symbolCount);
+    }
+    if (!in.good()) { return 1; }
+
+    analysis.rhsList.resize(pl.size());
+    for (auto &rhs : analysis.rhsList) {
+        rhs.isNillable = in.u8() != 0;
+        rhs.firstSet = in.set(symbolCount);
+        rhs.predictSet = in.set(symbolCount);
+    }
+
+    auto &table = analysis.table;
+    auto &compressed = analysis.compressed;
+    table.rowOfSymbol.assign(symbolCount, LL1Table::npos);
+    table.columnOfSymbol.assign(symbolCount, LL1Table::npos);
+    auto rowCount = in.u32();
+    auto columnCount = in.u32();
+    if (!in.good() || rowCount > symbolCount || columnCount > symbolCount) { return 1; }
+    table.nonterminals.resize(rowCount);
+    table.terminals.resize(columnCount);
+    for (std::size_t i = 0; i < rowCount && in.good(); ++i) {
+        auto id = in.u32();
+        if (id >= symbolCount || table.rowOfSymbol[id] != LL1Table::npos || st.getSymbol(id)->isTerminal()) { return 1; }
+        table.nonterminals[i] = st.getSymbol(id);
+        table.rowOfSymbol[id] = i;
+    }
+    for (std::size_t i = 0; i < columnCount && in.good(); ++i) {
+        auto id = in.u32();
+        if (id >= symbolCount || table.columnOfSymbol[id] != LL1Table::npos || !st.getSymbol(id)->isTerminal()) { return 1; }
+        table.terminals[i] = st.getSymbol(id);
+        table.columnOfSymbol[id] = i;
+    }
+
+    auto isValidCell = [&](LL1Table::Cell cell) { return cell >= LL1Table::conflictCell && cell < productionCount; };
+    compressed.rowCount = rowCount;
+    compressed.columnCount = columnCount;
+    compressed.base.resize(rowCount);
+    compressed.defaults.resize(rowCount);
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        compressed.base[row] = in.i32();
+        compressed.defaults[row] = in.i32();
+        if (compressed.base[row] < 0 || !isValidCell(compressed.defaults[row])) { return 1; }
+    }
+    auto entryCount = in.u32();
+    if (!in.good() || entryCount > data.size()) { return 1; }
+    compressed.entries.resize(entryCount);
+    compressed.check.resize(entryCount);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        compressed.entries[i] = in.i32();
+        compressed.check[i] = in.i32();
+        if (!isValidCell(compressed.entries[i]) || compressed.check[i] < CompressedLL1Table::noRow ||
+            compressed.check[i] >= static_cast<CompressedLL1Table::Index>(rowCount)) {
+            return 1;
+        }
+    }
+
+    auto conflictCellCount = expandLL1Table(analysis);
+    auto conflictCount = in.u32();
+    if (!in.good() || conflictCount != conflictCellCount) { return 1; }
+    for (std::size_t i = 0; i < conflictCount; ++i) {
+        auto index = in.u64();
+        auto size = in.u32();
+        if (!in.good() || size > pl.size()) { return 1; }
+        std::vector<int> ids(size);
+        for (auto &id : ids) { id = in.i32(); }
+        if (!addConflict(analysis, index, std::move(ids))) { return 1; }
+    }
+    if (!in.good() || !in.atEnd()) { return 1; }
+
+    restoreAnalysis(analysis);
+    return 0;
+}
+
+LL1AnalysisCache::LL1AnalysisCache(std::string directory, std::uintmax_t maxBytes)
+    : directory_(std::move(directory)), maxBytes_(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    // The cap may be less than the one the entries were stored with.
+    evict();
+}
+
+std::string LL1AnalysisCache::keyOf(GrammarContextPtr gc) {
+    std::string key;
+    Writer out(key);
+    out.u64(gc->st->symbolCount());
+    for (auto symbol : gc->st->table()) {
+        out.u8(static_cast<std::uint8_t>(symbol->getType()));
+        out.bytes(symbol->name());
+    }
+    out.u64(gc->pl->table().size());
+    for (auto &p : gc->pl->table()) {
+        out.u32(static_cast<std::uint32_t>(p.lhs.symbol->id()));
+        out.u32(static_cast<std::uint32_t>(p.rhs.symbolList.size()));
+        for (auto symbol : p.rhs.symbolList) { out.u32(static_cast<std::uint32_t>(symbol->id())); }
+    }
+    return key;
+}
+
+std::string LL1AnalysisCache::pathOf(const std::string &key) const {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hashOf(key)));
+    return (fs::path(directory_) / (std::string(name) + suffix)).string();
+}
+
+int LL1AnalysisCache::load(LL1Analyzer &theLL1Analyzer) {
+    auto gc = theLL1Analyzer.grammarContext();
+    if (gc == nullptr) { return 1; }
+
+    auto key = keyOf(gc);
+    auto path = pathOf(key);
+    std::string data;
+    {
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (ifs) {
+            data.resize(static_cast<std::size_t>(ifs.tellg()));
+            ifs.seekg(0);
+            if (!ifs.read(data.data(), static_cast<std::streamsize>(data.size()))) { data.clear(); }
+        }
+    }
+
+    Reader in(data);
+    bool isHit = data.size() >= sizeof(magic) && std::equal(magic, magic + sizeof(magic), data.begin());
+    if (isHit) {
+        for (std::size_t i = 0; i < sizeof(magic); ++i) { in.u8(); }
+        isHit = in.u32() == version && in.bytes() == key && in.good() &&
+                theLL1Analyzer.loadAnalysis(in.rest()) == 0;
+    }
+    if (!isHit) {
+        ++missCount_;
+        return 1;
+    }
+
+    // A hit makes the entry the most recently used one.
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    ++hitCount_;
+    return 0;
+}
+
+int LL1AnalysisCache::store(const LL1Analyzer &theLL1Analyzer) {
+    auto gc = theLL1Analyzer.grammarContext();
+    if (gc == nullptr || !theLL1Analyzer.isParsed()) { return 1; }
+
+    auto key = keyOf(gc);
+    std::string data(magic, sizeof(magic));
+    Writer out(data);
+    out.u32(version);
+    out.bytes(key);
+    if (theLL1Analyzer.saveAnalysis(data) != 0) { return 1; }
+
+    // Readers see the whole old entry or the whole new entry, never a part of it.
+    auto path = pathOf(key);
+    auto temporary = path + ".tmp" + std::to_string(std::random_device{}());
+    {
+        std::ofstream ofs(temporary, std::ios::binary);
+        if (!ofs || !ofs.write(data.data(), static_cast<std::streamsize>(data.size())) || !ofs.flush()) {
+            std::error_code ec;
+            ofs.close();
+            fs::remove(temporary, ec);
+            return 1;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporary, path, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return 1;
+    }
+
+    ++storeCount_;
+    // A replaced entry or the entries of other processes make the count inexact, the scan corrects it.
+    if (totalBytes_.fetch_add(data.size()) + data.size() > maxBytes_) { evict(); }
+    return 0;
+}
+
+int LL1AnalysisCache::parse(LL1Analyzer &theLL1Analyzer) {
+    if (load(theLL1Analyzer) == 0) { return 0; }
+    if (theLL1Analyzer.parse() != 0) { return 1; }
+    store(theLL1Analyzer);
+    return 0;
+}
+
+void LL1AnalysisCache::evict() {
+    std::lock_guard<std::mutex> lock(evictMutex_);
+
+    struct Entry {
+        fs::file_time_type time;
+        std::uintmax_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    std::uintmax_t totalSize = 0;
+    std::error_code ec;
+    auto staleTime = fs::file_time_type::clock::now() - staleAge;
+    auto temporary = std::string(suffix) + ".tmp";
+    for (auto &entry : fs::directory_iterator(directory_, ec)) {
+        if (!entry.is_regular_file(ec)) { continue; }
+        Entry e{entry.last_write_time(ec), entry.file_size(ec), entry.path()};
+        if (ec) { continue; }
+
+        // A temporary file being written counts, but it is not evicted.
+        if (e.path.filename().string().find(temporary) != std::string::npos) {
+            if (e.time >= staleTime || !fs::remove(e.path, ec)) { totalSize += e.size; }
+            continue;
+        }
+        if (e.path.extension() != suffix) { continue; }
+        totalSize += e.size;
+        entries.push_back(std::move(e));
+    }
+    totalBytes_ = totalSize;
+    if (totalSize <= maxBytes_) { return; }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.time < b.time; });
+    for (auto &entry : entries) {
+        if (totalSize <= maxBytes_) { break; }
+        if (fs::remove(entry.path, ec)) {
+            totalSize -= entry.size;
+            ++evictionCount_;
+        }
+    }
+    totalBytes_ = totalSize;
+}
+
+LL1AnalysisCache::Statistics LL1AnalysisCache::statistics() const {
+    Statistics statistics;
+    statistics.hitCount = hitCount_.load();
+    statistics.missCount = missCount_.load();
+    statistics.storeCount = storeCount_.load();
+    statistics.evictionCount = evictionCount_.load();
+    return statistics;
+}
@@ -0,0 +1,104 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "LL1Analyzer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace csa {
+
+/**
+ * @brief A content addressed cache of LL(1) analysis results on disk.
+ *
+ * The key of a grammar is its canonical form: the symbols in id order with their types,
+ * then the productions as symbol ids. Equal grammar files always give equal keys, and the
+ * results of a key are only valid for a grammar context with the same symbol ids.
+ * Every entry is a file named by the hash of its key, and it keeps the whole key, so a hash
+ * collision is a miss. Entries are written to a temporary file then renamed, so concurrent
+ * processes may share a cache directory.
+ *
+ * The size of all the entries is capped. A hit refreshes the modified time of its entry,
+ * and the entries with the oldest modified times are evicted first(LRU). The size is counted
+ * in memory after the directory is scanned once, it is scanned again only when the count is
+ * over the cap. The scan also removes the temporary files left by a crashed writer.
+ */
+class LL1AnalysisCache {
+public:
+    static constexpr std::uintmax_t defaultMaxBytes = 256 * 1024 * 1024;
+    static constexpr const char *suffix = ".ll1";
+    static constexpr std::chrono::hours staleAge{1};    ///< A temporary file older than it is left by a crash.
+
+    struct Statistics {
+        std::size_t hitCount = 0;         ///< Lookups which load the results.
+        std::size_t missCount = 0;        ///< Lookups which find no valid entry.
+        std::size_t storeCount = 0;       ///< Entries written.
+        std::size_t evictionCount = 0;    ///< Entries removed to keep the size cap.
+    };
+
+    /**
+     * @brief Construct a cache on a directory, it is created if not exists, and its old entries
+     * over the size cap are evicted.
+     *
+     * @param[in] directory     Directory of the entries.
+     * @param[in] maxBytes      Size cap of all the entries.
+     */
+    LL1AnalysisCache(std::string directory, std::uintmax_t maxBytes = defaultMaxBytes);
+    LL1AnalysisCache(const LL1AnalysisCache &) = delete;
+    LL1AnalysisCache &operator=(const LL1AnalysisCache &) = delete;
+
+    /**
+     * @brief Get the canonical form of a grammar, it is the key of its results.
+     */
+    static std::string keyOf(GrammarContextPtr gc);
+
+    /**
+     * @brief Load the results of the analyzer's grammar, instead of parsing it.
+     *
+     * @return int  0 if hit, and the analyzer is parsed.
+     */
+    int load(LL1Analyzer &theLL1Analyzer);
+
+    /**
+     * @brief Store the results of a parsed analyzer, then evict the old entries over the size cap.
+     *
+     * @return int  0 if pass.
+     */
+    int store(const LL1Analyzer &theLL1Analyzer);
+
+    /**
+     * @brief Load the results from the cache, or parse and store them.
+     *
+     * @return int  0 if pass.
+     */
+    int parse(LL1Analyzer &theLL1Analyzer);
+
+    Statistics statistics() const;
+    const std::string &directory() const { return directory_; }
+    std::uintmax_t maxBytes() const { return maxBytes_; }
+
+private:
+    std::string pathOf(const std::string &key) const;
+    void evict();
+
+    std::string directory_;
+    std::uintmax_t maxBytes_;
+    std::mutex evictMutex_;                      ///< Only one thread evicts at a time.
+    std::atomic<std::uintmax_t> totalBytes_{0};  ///< Size of the entries, counted since the last scan.
+    std::atomic<std::size_t> hitCount_{0};
+    std::atomic<std::size_t> missCount_{0};
+    std::atomic<std::size_t> storeCount_{0};
+    std::atomic<std::size_t> evictionCount_{0};
+};
+
+}    // namespace csa
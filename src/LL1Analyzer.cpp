@@ -8,135 +8,262 @@
  */
 
 #include "LL1Analyzer.h"
+#include "Digraph.h"
+
+#include <algorithm>
+#include <deque>
 
 using namespace csa;
 using namespace csa::html;
 
-using SymbolMappingId = std::map<SymbolPtr, std::size_t>;
-using IdMappingSymbol = std::map<std::size_t, SymbolPtr>;
-using CellId = std::pair<std::size_t, std::size_t>;
-using ProductionIdSet = std::set<std::size_t>;
-using CellIdMappingProductionIdSet = std::map<CellId, ProductionIdSet>;
-
 int LL1Analyzer::parse() {
     if(gc_ == nullptr){ return 1; }
     if(isParsed_){ return 0; }
 
+    analyze();
+    isParsed_ = true;
+
+    return 0;
+}
+
+void LL1Analyzer::analyze() {
     auto removeAllEpsilon = [&](){
+        auto epsilon = gc_->st->findSymbol(config::keyword::epsilon);
+        // A nonterminal may have no production after removeProduction(), so all of them are visited.
+        for (auto &symbol : gc_->st->table()) {
+            if (!symbol->isNonterminal()) { continue; }
+            setRemove(symbol->firstSet(), epsilon);
+            setRemove(symbol->followSet(), epsilon);
+        }
         for (auto &p : gc_->pl->table()) {
-            auto epsilon = gc_->st->findSymbol(config::keyword::epsilon);
-            setRemove(p.lhs.symbol->firstSet(), epsilon);
-            setRemove(p.lhs.symbol->followSet(), epsilon);
             setRemove(p.rhs.firstSet, epsilon);
             setRemove(p.rhs.predictSet, epsilon);
+            for (auto &suffix : p.rhs.suffixList) { setRemove(suffix.firstSet, epsilon); }
         }
     };
 
     initEPS();
     buildFirstSet();
+    buildSuffixList();
     buildFollowSet();
     buildPredictSet();
     //isValidLL1();
     removeAllEpsilon();
-    isParsed_ = true;
-
-    return 0;
+    buildLL1Table();
+    compressedLL1Table_.build(ll1Table_, gc_->pl->table());
 }
 
 std::string LL1Analyzer::buildHtmlTable(bool hasProductionTable, bool hasLL1Table){
-    if(!isParsed_){ return{}; }
-    HtmlBuilder builder(gc_, hasProductionTable, hasLL1Table);
-    return builder.buildHtmlTable();
+    std::string str;
+    {
+        StringOutputSink out(str);
+        if(buildHtmlTable(out, hasProductionTable, hasLL1Table) != 0){ return {}; }
+    }
+    return str;
 }
 
-void LL1Analyzer::initEPS() {
-    SymbolSet eps;
-    bool hasChange;
-    do {
-        hasChange = false;
-        for (auto &p : gc_->pl->table()) {
-            if (isEPS(p.rhs.symbolList)) {
-                p.lhs.symbol->setNillable(true);
-                p.rhs.isNillable = true;
-                if (eps.insert(p.lhs.symbol).second) { hasChange = true; }
-            }
-        }
-    } while (hasChange);
+int LL1Analyzer::buildHtmlTable(OutputSink &out, bool hasProductionTable, bool hasLL1Table){
+    if(!isParsed_){ return 1; }
+    HtmlBuilder builder(gc_, ll1Table_, out, hasProductionTable, hasLL1Table);
+    builder.buildHtmlTable();
+    return out.flush() ? 0 : 1;
+}
+
+int LL1Analyzer::buildCppParser(OutputSink &out, const std::string &className){
+    if(!isParsed_){ return 1; }
+    CppBuilder builder(gc_, ll1Table_, out, className);
+    if(builder.buildCppParser() != 0){ return 1; }
+    return out.flush() ? 0 : 1;
+}
+
+int LL1Analyzer::buildRecords(OutputSink &out, RecordFormat format){
+    if(!isParsed_){ return 1; }
+    RecordBuilder builder(gc_, ll1Table_, out, format);
+    builder.buildRecords();
+    return out.flush() ? 0 : 1;
 }
 
-bool LL1Analyzer::isEPS(const SymbolList &symbolList) {
-    std::size_t symbolCount = 0;
-    std::size_t nillableCount = 0;
+void LL1Analyzer::initEPS() {
+    auto &pl = gc_->pl->table();
+
+    // Each production counts its right hand symbols which are not known to be nillable yet,
+    // and each symbol remembers the productions it occurs in (once per occurrence).
+    std::vector<std::size_t> remainCount(pl.size(), 0);
+    std::vector<std::vector<std::size_t>> occurrences(gc_->st->symbolCount());
+    std::vector<SymbolPtr> worklist;
 
-    for (auto &symbol : symbolList) {
-        if (symbol->isNillable() || symbol->isTerminalEpsilon()) { ++nillableCount; }
-        ++symbolCount;
+    auto setNillable = [&](const Production &p) {
+        p.rhs.isNillable = true;
+        if (!p.lhs.symbol->isNillable()) {
+            p.lhs.symbol->setNillable(true);
+            worklist.push_back(p.lhs.symbol);
+        }
+    };
+
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        ++statistics_.nullableVisitCount;
+        for (auto &symbol : pl[i].rhs.symbolList) {
+            if (symbol->isTerminalEpsilon()) { continue; }
+            ++remainCount[i];
+            occurrences[symbol->id()].push_back(i);
+        }
+        if (remainCount[i] == 0) { setNillable(pl[i]); }
     }
 
-    return (symbolCount == nillableCount);
+    while (!worklist.empty()) {
+        auto symbol = worklist.back();
+        worklist.pop_back();
+        for (auto i : occurrences[symbol->id()]) {
+            ++statistics_.nullableVisitCount;
+            if (--remainCount[i] == 0) { setNillable(pl[i]); }
+        }
+    }
 }
 
 void LL1Analyzer::buildFirstSet() {
-    for (auto &item : gc_->st->table()) {
-        auto &symbol = item.second;
+    auto &pl = gc_->pl->table();
+
+    for (auto &symbol : gc_->st->table()) {
         symbol->firstSet().clear();
-        if (symbol->isTerminal()) { symbol->firstSet().insert(symbol); }
+        if (symbol->isTerminal()) { symbol->firstSet().insert(symbol->id()); }
+    }
+    if (jobs_ > 1) {
+        buildFirstSetByDigraph();
+        return;
     }
 
-    bool hasChange;
-    do {
-        hasChange = false;
-        for (auto &p : gc_->pl->table()) {
-            auto tempSet = calculateFirstSet(p.rhs.symbolList);
-            if (setUnion(p.lhs.symbol->firstSet(), tempSet)) { hasChange = true; }
+    // A symbol's left corner users are the productions whose first set depends on it,
+    // only they need to be visited again when the symbol's first set grows.
+    std::vector<std::vector<std::size_t>> leftCornerUsers(gc_->st->symbolCount());
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        for (auto &symbol : pl[i].rhs.symbolList) {
+            if (symbol->isNonterminal()) { leftCornerUsers[symbol->id()].push_back(i); }
+            if (!symbol->isNillable()) { break; }
         }
-    } while (hasChange);
-}
+    }
 
-SymbolSet LL1Analyzer::calculateFirstSet(const SymbolList &symbolList) {
-    SymbolSet set;
+    std::deque<std::size_t> worklist;
+    std::vector<bool> isQueued(pl.size(), true);
+    for (std::size_t i = 0; i < pl.size(); ++i) { worklist.push_back(i); }
 
-    for (auto &symbol : symbolList) {
-        setUnion(set, symbol->firstSet());
-        if (!symbol->isNillable()) { break; }
-    }
+    while (!worklist.empty()) {
+        auto &p = pl[worklist.front()];
+        isQueued[worklist.front()] = false;
+        worklist.pop_front();
+        ++statistics_.firstSetVisitCount;
+
+        bool hasChange = false;
+        for (auto &symbol : p.rhs.symbolList) {
+            if (setUnion(p.lhs.symbol->firstSet(), symbol->firstSet())) { hasChange = true; }
+            if (!symbol->isNillable()) { break; }
+        }
 
-    return set;
+        if (hasChange) {
+            for (auto i : leftCornerUsers[p.lhs.symbol->id()]) {
+                if (!isQueued[i]) {
+                    isQueued[i] = true;
+                    worklist.push_back(i);
+                }
+            }
+        }
+    }
 }
 
-bool LL1Analyzer::setUnion(SymbolSet &set1, SymbolSet &set2) {
-    bool hasChange = false;
+void LL1Analyzer::buildFirstSetByDigraph() {
+    // For production A -> xBy where x is nillable, First(A) includes First(B). Terminals in the
+    // left corners are the initial sets, and nonterminals in the left corners are the relation edges.
+    Relation leftCorners(gc_->st->symbolCount());
+    std::vector<SymbolSet> sets(gc_->st->symbolCount());
 
-    for (auto &symbol : set2) {
-        if(set1.insert(symbol).second){
-            hasChange = true;
+    for (auto &p : gc_->pl->table()) {
+        ++statistics_.firstSetVisitCount;
+        auto lhs = p.lhs.symbol->id();
+        for (auto &symbol : p.rhs.symbolList) {
+            if (symbol->isNonterminal()) {
+                leftCorners[lhs].push_back(symbol->id());
+            } else {
+                sets[lhs].insert(symbol->id());
+            }
+            if (!symbol->isNillable()) { break; }
         }
     }
 
-    return hasChange;
+    digraph(leftCorners, sets, jobs_);
+
+    for (auto &symbol : gc_->st->table()) {
+        if (symbol->isNonterminal()) { symbol->firstSet() = std::move(sets[symbol->id()]); }
+    }
 }
 
-bool LL1Analyzer::setRemove(SymbolSet &set, SymbolPtr symbol) {
-    auto it = set.find(symbol);
+void LL1Analyzer::forEachProduction(const std::function<void(const Production &)> &visit) {
+    auto &pl = gc_->pl->table();
+    if (jobs_ <= 1) {
+        for (auto &p : pl) { visit(p); }
+        return;
+    }
+
+    // Productions are visited in chunks, a chunk is a task of the pool.
+    constexpr std::size_t chunkSize = 256;
+    WorkStealingPool<std::size_t> pool(jobs_);
+    for (std::size_t begin = 0; begin < pl.size(); begin += chunkSize) { pool.push(begin / chunkSize % jobs_, begin); }
+    pool.run([&](std::size_t begin, std::size_t) {
+        auto end = std::min(begin + chunkSize, pl.size());
+        for (auto i = begin; i < end; ++i) { visit(pl[i]); }
+    });
+}
 
-    if (it != set.end()) {
-        set.erase(it);
-        return true;
+void LL1Analyzer::buildSuffixList() {
+    // Walk each right-hand-side from right to left once, so that every suffix reuses
+    // the suffix behind it: First(Xy) = First(X) + (X is nillable ? First(y) : {}).
+    forEachProduction([&](const Production &p) { buildSuffixList(p); });
+}
+
+void LL1Analyzer::buildSuffixList(const Production &p) {
+    auto &symbolList = p.rhs.symbolList;
+    auto &suffixList = p.rhs.suffixList;
+    suffixList.assign(symbolList.size() + 1, {});
+
+    for (auto i = symbolList.size(); i-- > 0;) {
+        auto &symbol = symbolList[i];
+        auto &suffix = suffixList[i];
+        if (symbol->isNillable()) {
+            suffix.firstSet = suffixList[i + 1].firstSet;
+            suffix.isNillable = suffixList[i + 1].isNillable;
+        } else {
+            suffix.isNillable = false;
+        }
+        setUnion(suffix.firstSet, symbol->firstSet());
     }
+}
 
-    return false;
+bool LL1Analyzer::setUnion(SymbolSet &set1, SymbolSet &set2) {
+    return set1.unite(set2);
+}
+
+bool LL1Analyzer::setRemove(SymbolSet &set, SymbolPtr symbol) {
+    return set.erase(symbol->id());
 }
 
 void LL1Analyzer::buildFollowSet() {
+    if (followSetEngine_ == FollowSetEngine::fixpoint) {
+        buildFollowSetByFixpoint();
+    } else {
+        buildFollowSetByDigraph();
+    }
+}
+
+void LL1Analyzer::buildFollowSetByFixpoint() {
     bool hasChange;
     do {
         hasChange = false;
         for (auto &p : gc_->pl->table()) {
-            for (auto beg = p.rhs.symbolList.begin(); beg < (p.rhs.symbolList.end() - 1); ++beg) {
-                if ((*beg)->isNonterminal()) {
-                    SymbolList symbolList(beg + 1, p.rhs.symbolList.end());
-                    auto tempSet = calculateFirstSet(symbolList);
-                    if (setUnion((*beg)->followSet(), tempSet)) { hasChange = true; }
+            ++statistics_.followSetVisitCount;
+            for (std::size_t i = 0; i + 1 < p.rhs.symbolList.size(); ++i) {
+                auto &symbol = p.rhs.symbolList[i];
+                if (symbol->isNonterminal()) {
+                    if (setUnion(symbol->followSet(), p.rhs.suffixList[i + 1].firstSet)) {
+                        hasChange = true;
+                    }
                 }
             }
             for (auto rbeg = p.rhs.symbolList.rbegin(); rbeg < p.rhs.symbolList.rend(); ++rbeg) {
@@ -151,12 +278,199 @@ void LL1Analyzer::buildFollowSet() {
     } while (hasChange);
 }
 
+void LL1Analyzer::buildFollowSetByDigraph() {
+    // For production A -> xBy, Follow(B) includes First(y), they are the initial sets;
+    // and if y is nillable, Follow(B) includes Follow(A), they are the relation edges.
+    Relation includes(gc_->st->symbolCount());
+    std::vector<SymbolSet> sets(gc_->st->symbolCount());
+
+    for (auto &p : gc_->pl->table()) {
+        ++statistics_.followSetVisitCount;
+        auto &symbolList = p.rhs.symbolList;
+
+        for (std::size_t i = 0; i < symbolList.size(); ++i) {
+            auto &symbol = symbolList[i];
+            if (symbol->isNonterminal()) {
+                auto &tail = p.rhs.suffixList[i + 1];
+                setUnion(sets[symbol->id()], tail.firstSet);
+                if (tail.isNillable) { includes[symbol->id()].push_back(p.lhs.symbol->id()); }
+            }
+        }
+    }
+
+    digraph(includes, sets, jobs_);
+
+    for (auto &symbol : gc_->st->table()) {
+        if (symbol->isNonterminal()) { setUnion(symbol->followSet(), sets[symbol->id()]); }
+    }
+}
+
 void LL1Analyzer::buildPredictSet() {
+    forEachProduction([&](const Production &p) { buildPredictSet(p); });
+}
+
+void LL1Analyzer::buildPredictSet(const Production &p) {
+    p.rhs.firstSet = p.rhs.suffixList.front().firstSet;
+    p.rhs.predictSet = p.rhs.firstSet;
+    if (p.rhs.isNillable) { setUnion(p.rhs.predictSet, p.lhs.symbol->followSet()); }
+}
+
+void LL1Analyzer::buildLL1Table() {
+    auto &table = ll1Table_;
+    table.clear();
+    buildLL1TableHeader(table);
+
+    // Fill the cells from predict sets in one pass.
+    table.cells.assign(table.rowCount() * table.columnCount(), LL1Table::emptyCell);
+    for (auto &p : gc_->pl->table()) { fillLL1Table(p); }
+}
+
+void LL1Analyzer::buildLL1TableHeader(LL1Table &table) const {
+    auto &pl = gc_->pl->table();
+    table.rowOfSymbol.assign(gc_->st->symbolCount(), LL1Table::npos);
+    table.columnOfSymbol.assign(gc_->st->symbolCount(), LL1Table::npos);
+
+    // Rows are nonterminals in the order of their first production.
+    for (auto &p : pl) {
+        auto &row = table.rowOfSymbol[p.lhs.symbol->id()];
+        if (row == LL1Table::npos) {
+            row = table.nonterminals.size();
+            table.nonterminals.push_back(p.lhs.symbol);
+        }
+    }
+
+    // Columns are terminals in the order they first appear.
+    SymbolPtr theEofSymbol = nullptr;
+    for (auto &p : pl) {
+        for (auto &t : p.rhs.symbolList) {
+            if (t->isNonterminal() || t->isTerminalEpsilon()) { continue; }
+            auto &column = table.columnOfSymbol[t->id()];
+            if (column == LL1Table::npos) {
+                column = table.terminals.size();
+                table.terminals.push_back(t);
+            }
+            if (t->isTerminalEof()) { theEofSymbol = t; }
+        }
+    }
+
+    // Make terminal(eof) bind with the last column.
+    if (theEofSymbol != nullptr && table.terminals.back() != theEofSymbol) {
+        auto theLastSymbol = table.terminals.back();
+        auto &theLastColumn = table.columnOfSymbol[theLastSymbol->id()];
+        auto &theEofColumn = table.columnOfSymbol[theEofSymbol->id()];
+        std::swap(table.terminals[theLastColumn], table.terminals[theEofColumn]);
+        std::swap(theLastColumn, theEofColumn);
+    }
+}
+
+void LL1Analyzer::fillLL1Table(const Production &p) {
+    auto &table = ll1Table_;
+    auto row = table.rowOfSymbol[p.lhs.symbol->id()];
+    for (auto id : p.rhs.predictSet) {
+        auto column = table.columnOfSymbol[id];
+        if (column == LL1Table::npos) { continue; }
+        auto index = table.cellIndex(row, column);
+        auto &cell = table.cells[index];
+        if (cell == LL1Table::emptyCell) {
+            cell = p.id;
+        } else if (cell == LL1Table::conflictCell) {
+            table.conflicts[index].push_back(p.id);
+        } else {
+            table.conflicts[index] = {cell, p.id};
+            cell = LL1Table::conflictCell;
+        }
+    }
+}
+
+void LL1Analyzer::updateLL1Table(const std::vector<bool> &isLhsChanged, int from, int delta) {
+    auto &table = ll1Table_;
+    LL1Table header;
+    buildLL1TableHeader(header);
+    if (header.nonterminals != table.nonterminals || header.terminals != table.terminals) {
+        buildLL1Table();
+        compressedLL1Table_.build(ll1Table_, gc_->pl->table());
+        return;
+    }
+    table.rowOfSymbol = std::move(header.rowOfSymbol);
+    table.columnOfSymbol = std::move(header.columnOfSymbol);
+
+    // The old production ids from "from" are moved by delta, after a production is inserted or erased.
+    if (from < static_cast<int>(gc_->pl->table().size()) - delta) {
+        auto renumber = [from, delta](LL1Table::Cell &cell) {
+            if (cell >= from) { cell += delta; }
+        };
+        std::for_each(table.cells.begin(), table.cells.end(), renumber);
+        for (auto &[index, ids] : table.conflicts) { std::for_each(ids.begin(), ids.end(), renumber); }
+        std::for_each(compressedLL1Table_.defaults.begin(), compressedLL1Table_.defaults.end(), renumber);
+        std::for_each(compressedLL1Table_.entries.begin(), compressedLL1Table_.entries.end(), renumber);
+    }
+
+    // Refill the rows of the changed nonterminals, in production order like buildLL1Table().
+    auto columnCount = table.columnCount();
+    std::vector<std::size_t> rows;
+    for (std::size_t row = 0; row < table.rowCount(); ++row) {
+        if (!isLhsChanged[table.nonterminals[row]->id()]) { continue; }
+        rows.push_back(row);
+        auto begin = table.cellIndex(row, 0);
+        std::fill_n(table.cells.begin() + static_cast<std::ptrdiff_t>(begin), columnCount, LL1Table::emptyCell);
+        table.conflicts.erase(table.conflicts.lower_bound(begin), table.conflicts.lower_bound(begin + columnCount));
+    }
     for (auto &p : gc_->pl->table()) {
-        p.rhs.firstSet = calculateFirstSet(p.rhs.symbolList);
-        p.rhs.predictSet = p.rhs.firstSet;
-        if (p.rhs.isNillable) { setUnion(p.rhs.predictSet, p.lhs.symbol->followSet()); }
+        if (isLhsChanged[p.lhs.symbol->id()]) { fillLL1Table(p); }
+    }
+    compressedLL1Table_.update(table, gc_->pl->table(), rows);
+}
+
+std::size_t LL1Analyzer::expandLL1Table(LoadedAnalysis &analysis) {
+    auto &table = analysis.table;
+    auto &compressed = analysis.compressed;
+    table.cells.resize(compressed.rowCount * compressed.columnCount);
+    std::size_t conflictCellCount = 0;
+    for (std::size_t row = 0; row < compressed.rowCount; ++row) {
+        for (std::size_t column = 0; column < compressed.columnCount; ++column) {
+            auto cell = compressed.at(row, column);
+            table.cells[table.cellIndex(row, column)] = cell;
+            if (cell == LL1Table::conflictCell) { ++conflictCellCount; }
+        }
     }
+    return conflictCellCount;
+}
+
+bool LL1Analyzer::addConflict(LoadedAnalysis &analysis, std::size_t index, std::vector<int> ids) {
+    // Conflicts are read in cell order, so every one is put at the end of the map.
+    auto &table = analysis.table;
+    auto productionCount = static_cast<int>(analysis.rhsList.size());
+    if (index >= table.cells.size() || table.cells[index] != LL1Table::conflictCell ||
+        (!table.conflicts.empty() && index <= table.conflicts.rbegin()->first) ||
+        std::any_of(ids.begin(), ids.end(), [&](int id) { return id < 0 || id >= productionCount; })) {
+        return false;
+    }
+    table.conflicts.emplace_hint(table.conflicts.end(), index, std::move(ids));
+    return true;
+}
+
+void LL1Analyzer::restoreAnalysis(LoadedAnalysis &analysis) {
+    auto &st = *gc_->st;
+    auto &pl = gc_->pl->table();
+    for (auto symbol : st.table()) {
+        auto &result = analysis.symbols[symbol->id()];
+        symbol->setNillable(result.isNillable);
+        symbol->firstSet() = std::move(result.firstSet);
+        symbol->followSet() = std::move(result.followSet);
+    }
+    // Suffix lists are not loaded, they take one pass from the symbols' sets.
+    auto epsilon = st.findSymbol(config::keyword::epsilon);
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        auto &rhs = pl[i].rhs;
+        rhs.isNillable = analysis.rhsList[i].isNillable;
+        rhs.firstSet = std::move(analysis.rhsList[i].firstSet);
+        rhs.predictSet = std::move(analysis.rhsList[i].predictSet);
+        buildSuffixList(pl[i]);
+        for (auto &suffix : rhs.suffixList) { setRemove(suffix.firstSet, epsilon); }
+    }
+    ll1Table_ = std::move(analysis.table);
+    compressedLL1Table_ = std::move(analysis.compressed);
+    isParsed_ = true;
 }
 
 bool LL1Analyzer::isValidLL1() {
@@ -167,15 +481,8 @@ bool LL1Analyzer::isValidLL1() {
     bool good = true;
     std::map<SymbolPtr, SymbolSet> symbolAndSet;
 
-    auto hasIntersection = [](const SymbolSet &set1, const SymbolSet &set2) {
-        for (auto &symbol : set2) {
-            if (set1.find(symbol) != set1.end()) { return true; }
-        }
-        return false;
-    };
-
     for (auto &p : gc_->pl->table()) {
-        if (hasIntersection(symbolAndSet[p.lhs.symbol], p.rhs.predictSet)) {
+        if (symbolAndSet[p.lhs.symbol].intersects(p.rhs.predictSet)) {
             printf("[LL1Analyzer::isValidLL1]\n");
             printf("  [note] production(id=%d) has conflict predict set, ", p.id);
             printf("it's invalid LL1 grammar.\n");
@@ -188,50 +495,64 @@ bool LL1Analyzer::isValidLL1() {
     return good;
 }
 
-std::string LL1Analyzer::HtmlBuilder::buildHtmlTable() {
+void LL1Analyzer::HtmlBuilder::buildHtmlTable() {
 
     if(buildProductionTable_ || buildLL1Table_){
-        std::string str = line("<!DOCTYPE html>");
-        str += line("<html>");
-        str += buildHtmlHead();
-        str += buildHtmlBody();
-        str += line("</html>");
-        return str;
+        out_ << line("<!DOCTYPE html>");
+        out_ << line("<html>");
+        buildHtmlHead();
+        buildHtmlBody();
+        out_ << line("</html>");
     }
-
-    return {};
 }
 
-std::string LL1Analyzer::HtmlBuilder::buildHtmlHead() {
-    return "<head></head>";
+void LL1Analyzer::HtmlBuilder::buildHtmlHead() {
+    out_ << "<head></head>";
 }
 
-std::string LL1Analyzer::HtmlBuilder::buildHtmlBody() {
-    std::string str = line("<body>");
+void LL1Analyzer::HtmlBuilder::buildHtmlBody() {
+    out_ << line("<body>");
 
     if(buildProductionTable_){
-        str += buildHtmlTableOfProductionTable();
+        buildHtmlTableOfProductionTable();
     }
 
     if(buildLL1Table_){
-        str += buildHtmlTableOfLL1Table();
+        buildHtmlTableOfLL1Table();
     }
 
-    str += line("</body>");
-    return str;
+    out_ << line("</body>");
 }
 
-std::string LL1Analyzer::HtmlBuilder::buildHtmlTableOfProductionTable() {
-    auto addTableTitle = [&](std::string title = "Production Table"){
-        std::string str;
-        str += "<h2>";
-        str += title;
-        str += "</h2>\n";
-        return str;
+void LL1Analyzer::HtmlBuilder::formatCell(std::string_view text) {
+    for (auto &c : text) {
+        if (c == ' ') {
+            out_ << "&nbsp;";
+        } else if (c == '<') {
+            out_ << "&lt;";
+        } else if (c == '>') {
+            out_ << "&gt;";
+        } else if (c == '&') {
+            out_ << "&amp;";
+        } else if (c == '"') {
+            out_ << "&quot;";
+        } else if (c == '\'') {
+            out_ << "&apos;";
+        } else {
+            out_ << c;
+        }
+    }
+}
+
+void LL1Analyzer::HtmlBuilder::buildHtmlTableOfProductionTable() {
+    auto addTableTitle = [&](std::string_view title = "Production Table"){
+        out_ << "<h2>";
+        out_ << title;
+        out_ << "</h2>\n";
     };
 
     auto addTableStyle = [&](){
-    return R"(
+    out_ << R"(
     <style type="text/css">
         .tg {
             border-collapse: collapse;
@@ -320,7 +641,7 @@ std::string LL1Analyzer::HtmlBuilder::buildHtmlTableOfProductionTable() {
     };
 
     auto addProductionTableHead = [&](){
-        return R"(
+        out_ << R"(
         <thead>
             <tr>
                 <th class="tg-1tol">Id</th>
@@ -334,169 +655,75 @@ std::string LL1Analyzer::HtmlBuilder::buildHtmlTableOfProductionTable() {
         )";
     };
 
-    auto addRecord = [&](std::string id, 
-                         std::string production, 
-                         std::string firstSet, 
-                         std::string followSet,
-                         std::string predictSet, 
-                         std::string isNillable) {
-        std::string str;
-        str += line("<tr>");
-        str +=  "<td class=\"tg-hos7\">" + formatCell(id) + "</td>\n";
-        str +=  "<td class=\"tg-8m2j\">" + formatCell(production) + "</td>\n";
-        str +=  "<td class=\"tg-8m2j\">" + formatCell(firstSet) + "</td>\n";
-        str +=  "<td class=\"tg-8m2j\">" + formatCell(followSet) + "</td>\n";
-        str +=  "<td class=\"tg-8m2j\">" + formatCell(predictSet) + "</td>\n";
-        str +=  "<td class=\"tg-hos7\">" + formatCell(isNillable) + "</td>\n";
-        str += line("</tr>");
-        return str;
+    auto addSymbolSet = [&](const SymbolSet &set) {
+        bool isFirst = true;
+        for (auto id : set) {
+            if (!isFirst) { formatCell(" "); }
+            formatCell(gc_->st->getSymbol(id)->name());
+            isFirst = false;
+        }
     };
 
-    auto idToStr = [](const std::size_t id) { return std::to_string(id); };
-
-    auto symbolSetToStr = [](const SymbolSet &set) {
-        std::string stream;
-        for (auto &symbol : set) {
-            if (!stream.empty()) { stream += " "; }
-            stream += symbol->name();
-        }
-        return stream;
+    auto addRecord = [&](std::size_t id, const Production &p) {
+        out_ << line("<tr>");
+        out_ << "<td class=\"tg-hos7\">";
+        formatCell(std::to_string(id));
+        out_ << "</td>\n";
+        out_ << "<td class=\"tg-8m2j\">";
+        formatCell(gc_->pl->toString(p));
+        out_ << "</td>\n";
+        out_ << "<td class=\"tg-8m2j\">";
+        addSymbolSet(p.rhs.firstSet);
+        out_ << "</td>\n";
+        out_ << "<td class=\"tg-8m2j\">";
+        addSymbolSet(p.lhs.symbol->followSet());
+        out_ << "</td>\n";
+        out_ << "<td class=\"tg-8m2j\">";
+        addSymbolSet(p.rhs.predictSet);
+        out_ << "</td>\n";
+        out_ << "<td class=\"tg-hos7\">";
+        formatCell(p.rhs.isNillable ? "yes" : "no");
+        out_ << "</td>\n";
+        out_ << line("</tr>");
     };
 
     auto addProductionTableBody = [&](){
-        std::string str;
-
-        str += line("<tbody>");
+        out_ << line("<tbody>");
 
         // Create table records.
         std::size_t id = 1;
         for (auto &p : gc_->pl->table()) {
-            str += addRecord(idToStr(id++), 
-                             gc_->pl->toString(p), 
-                             symbolSetToStr(p.rhs.firstSet),
-                             symbolSetToStr(p.lhs.symbol->followSet()),
-                             symbolSetToStr(p.rhs.predictSet), 
-                             p.rhs.isNillable ? "yes" : "no");
+            addRecord(id++, p);
         }
 
-        str += line("</tbody>");
-
-        return str;
+        out_ << line("</tbody>");
     };
 
     auto addProductionTable = [&](){
-        std::string str;
-        str += addTableTitle();
-        str += addTableStyle();
-        str += line("<table class=\"tg\">");
-        str += addProductionTableHead();
-        str += addProductionTableBody();
-        str += line("</table>");
-        return str;
+        addTableTitle();
+        addTableStyle();
+        out_ << line("<table class=\"tg\">");
+        addProductionTableHead();
+        addProductionTableBody();
+        out_ << line("</table>");
     };
 
-    return addProductionTable();
+    addProductionTable();
 }
 
-std::string LL1Analyzer::HtmlBuilder::buildHtmlTableOfLL1Table() {
-    // ------------------------------------------------------------
-    // Extrat table info functions.
-    // ------------------------------------------------------------
-    
-    // terminal bind id;
-    auto buildTerminlMappingId = [&](const ProductionList &pl) {
-        SymbolMappingId terminalMappingId;
-        std::size_t id = 1;
-
-        SymbolPtr theLastSymbol = nullptr;
-        SymbolPtr theEofSymbol = nullptr;
-
-        for (auto &p : pl) {
-            for (auto &t : p.rhs.symbolList) {
-                if(t->isNonterminal() || t->isTerminalEpsilon()) continue;
-                auto &thisId = terminalMappingId[t];
-                if (thisId == 0) {
-                    thisId = id++;
-                    theLastSymbol = t;
-                }
-                if (t->isTerminalEof()) { theEofSymbol = t; }
-            }
-        }
-
-        // Make terminal(eof) bind with the last id,
-        // so that it always appears at the last colunm of the html table.
-        if (theLastSymbol != nullptr && theEofSymbol != nullptr && theLastSymbol != theEofSymbol) {
-            auto &theLastSymbolId = terminalMappingId[theLastSymbol];
-            auto &theEofSymbolId = terminalMappingId[theEofSymbol];
-            std::swap(theLastSymbolId, theEofSymbolId);
-        }
-
-        return terminalMappingId;
-    };
-
-    // nonterminal bind id;
-    auto buildNonterminalMappingId = [&](const ProductionList &pl) {
-        SymbolMappingId nonterminalMappingId;
-        std::size_t id = 1;
-        for (auto &p : pl) {
-            auto &thisId = nonterminalMappingId[p.lhs.symbol];
-            if (thisId == 0) { thisId = id++; }
-        }
-        return nonterminalMappingId;
-    };
-
-    // cell bind production-id-set.
-    auto buildCellIdMappingProductionIdSet = [&](const ProductionList &pl,
-                                                 SymbolMappingId &terminalMappingId,
-                                                 SymbolMappingId &nonterminalMappingId) {
-        CellIdMappingProductionIdSet cmp;
-        std::size_t productionId = 1;
-
-        for (auto &p : pl) {
-            auto &nt = p.lhs.symbol;
-            for (auto &t : p.rhs.predictSet) {
-                CellId cellId;
-                cellId.first = nonterminalMappingId[nt];
-                cellId.second = terminalMappingId[t];
-                cmp[cellId].insert(productionId);
-            }
-            ++productionId;
-        }
-
-        return cmp;
-    };
-
-    // id bind symbol (and sorted by id).
-    auto toIdMappingSymbol = [](const SymbolMappingId &symbolMappingId) {
-        IdMappingSymbol ims;
-        for (auto &item : symbolMappingId) { ims[item.second] = item.first; }
-        return ims;
-    };
-
-    // ------------------------------------------------------------
-    // Common data.
-    // ------------------------------------------------------------
-    auto terminalMappingId = buildTerminlMappingId(gc_->pl->table());
-    auto nonterminalMappingId = buildNonterminalMappingId(gc_->pl->table());
-    auto cellIdMappingProductionIdSet =
-        buildCellIdMappingProductionIdSet(gc_->pl->table(), terminalMappingId, nonterminalMappingId);
-    auto idMappingTerminal = toIdMappingSymbol(terminalMappingId);
-    auto idMappingNonterminal = toIdMappingSymbol(nonterminalMappingId);
-
+void LL1Analyzer::HtmlBuilder::buildHtmlTableOfLL1Table() {
     // ------------------------------------------------------------
     // Html functions.
     // ------------------------------------------------------------
 
-    auto addTableTitle = [&](std::string title = "LL(1) Table"){
-        std::string str;
-        str += "<h2>";
-        str += title;
-        str += "</h2>\n";
-        return str;
+    auto addTableTitle = [&](std::string_view title = "LL(1) Table"){
+        out_ << "<h2>";
+        out_ << title;
+        out_ << "</h2>\n";
     };
 
     auto addTableStyle = [&](){
-        return R"(
+        out_ << R"(
     <style type="text/css">
         .tg {
             border-collapse: collapse;
@@ -580,102 +807,73 @@ std::string LL1Analyzer::HtmlBuilder::buildHtmlTableOfLL1Table() {
         )";
     };
 
-    auto getTerminalCount = [&](){
-        return std::to_string(idMappingTerminal.size());
-    };
-
-    auto getTerminalList = [&](){
-        std::vector<std::string> terminals;
-
-        for(auto& pair: idMappingTerminal){
-            terminals.push_back(pair.second->name());
-        }
-        
-        return terminals;
-    };
-
     auto addTableHead = [&](){
-        std::string str;
-        auto terminalList = getTerminalList();
-
-        str += line("<thead>");
+        out_ << line("<thead>");
 
-        str += line("<tr>");
-        str += line("<th class=\"tg-1tol\" rowspan=\"2\">Nonterminal</th>");
-        str += "<th class=\"tg-mqa1\" colspan=\"" + getTerminalCount() + "\">Terminal</th>\n";
-        str += line("</tr>");
+        out_ << line("<tr>");
+        out_ << line("<th class=\"tg-1tol\" rowspan=\"2\">Nonterminal</th>");
+        out_ << "<th class=\"tg-mqa1\" colspan=\"" << table_.columnCount() << "\">Terminal</th>\n";
+        out_ << line("</tr>");
 
-        str += line("<tr>");
-        for(auto const& terminal: terminalList){
-            str += "<th class=\"tg-mqa1\">";
-            str += formatCell(terminal);
-            str += "</th>\n";
+        out_ << line("<tr>");
+        for(auto& terminal: table_.terminals){
+            out_ << "<th class=\"tg-mqa1\">";
+            formatCell(terminal->name());
+            out_ << "</th>\n";
         }
-        str += line("</tr>");
+        out_ << line("</tr>");
 
-        str += line("</thead>");
-
-        return str;
+        out_ << line("</thead>");
     };
 
-    auto productionIdSetToStr = [](const ProductionIdSet& ids){
-        std::string str;
+    // Production ids are shown from 1, the same as the production table.
+    auto addProductionId = [&](int id){
+        out_ << static_cast<std::size_t>(id + 1);
+    };
 
-        for(auto& id : ids){
-            if(!str.empty()){
-                str += " ";
+    auto addCell = [&](std::size_t row, std::size_t column){
+        out_ << "<td class=\"tg-8m2j\">";
+        auto cell = table_.at(row, column);
+        if (cell == LL1Table::conflictCell) {
+            bool isFirst = true;
+            for (auto id : table_.conflicts.at(table_.cellIndex(row, column))) {
+                if (!isFirst) { formatCell(" "); }
+                addProductionId(id);
+                isFirst = false;
             }
-            str += std::to_string(id);
+        } else if (cell != LL1Table::emptyCell) {
+            addProductionId(cell);
         }
-
-        return str;
-    };
-
-    auto addCell = [&](std::string text){
-        std::string str;
-        str += "<td class=\"tg-8m2j\">" + formatCell(text) + "</td>\n";
-        return str;
+        out_ << "</td>\n";
     };
 
     auto addTableRecords = [&](){
-        std::string str;
-
-        for (auto &ntItem : idMappingNonterminal) {
-            str += line("<tr>");
-            str += "<td class=\"tg-hos7\">" + formatCell(ntItem.second->name()) +"</td>";
-            for (auto &tItem : idMappingTerminal) {
-                CellId cellId;
-                cellId.first = ntItem.first;
-                cellId.second = tItem.first;
-                auto cell = productionIdSetToStr(cellIdMappingProductionIdSet[cellId]);
-                str += addCell(cell);
+        for (std::size_t row = 0; row < table_.rowCount(); ++row) {
+            out_ << line("<tr>");
+            out_ << "<td class=\"tg-hos7\">";
+            formatCell(table_.nonterminals[row]->name());
+            out_ << "</td>";
+            for (std::size_t column = 0; column < table_.columnCount(); ++column) {
+                addCell(row, column);
             }
-            str += line("</tr>");
+            out_ << line("</tr>");
         }
-
-        return str;
     };
 
     auto addTableBody = [&](){
-        std::string str;
-
-        str += line("<tbody>");
-        str += addTableRecords();
-        str += line("</tbody>");
-
-        return str;
+        out_ << line("<tbody>");
+        addTableRecords();
+        out_ << line("</tbody>");
     };
 
     auto addTable = [&](){
-        std::string str;
-        str += addTableTitle();
-        str += addTableStyle();
-        str += line("<table class=\"tg\">");
-        str += addTableHead();
-        str += addTableBody();
-        str += line("</table>");
-        return str;
+        addTableTitle();
+        addTableStyle();
+        out_ << line("<table class=\"tg\">");
+        addTableHead();
+        addTableBody();
+        out_ << line("</table>");
     };
 
-    return addTable();
+    addTable();
 }
@@ -10,23 +10,230 @@
 #pragma once
 
 #include "BaseType.h"
+#include "OutputSink.h"
 #include <cassert>
 
 namespace csa {
+class GrammarImage;
+
 class LL1Analyzer {
 public:
+    /**
+     * @brief The engine used to build follow sets.
+     */
+    enum class FollowSetEngine : int {
+        fixpoint = 0,    ///< Rescan all the productions until no follow set grows.
+        digraph          ///< Collapse SCCs of the inclusion graph, solve each SCC in one pass.
+    };
+
+    /**
+     * @brief The format of the records built by buildRecords().
+     */
+    enum class RecordFormat : int {
+        json = 0,    ///< One JSON object, a record per line.
+        csv          ///< A record per line, its first field is the kind of the record.
+    };
+
     LL1Analyzer(GrammarContextPtr gc) : gc_(gc), isParsed_(false){}
+    void setFollowSetEngine(FollowSetEngine engine) { followSetEngine_ = engine; }
+
+    /**
+     * @brief Set the count of the threads, more than one enables the parallel analysis.
+     *
+     * First sets and follow sets(by the digraph engine) are solved over the DAG of strongly
+     * connected components, independent components in parallel. Suffix and predict sets are
+     * built for many productions in parallel. The results are the same as the serial analysis.
+     */
+    void setJobs(std::size_t jobs) { jobs_ = jobs; }
     int parse();
+    bool isParsed() const { return isParsed_; }
+    GrammarContextPtr grammarContext() const { return gc_; }
+
+    /**
+     * @brief Add a production to the parsed grammar, and update the analysis incrementally.
+     *
+     * Nillable, first, follow and predict sets only grow after an addition, so they grow from
+     * the new production and the symbols which become nillable, other productions are not visited.
+     * A new symbol on the right hand side is a terminal. The productions may move, so
+     * the LR analyzers built before must be built again.
+     *
+     * @param[in] lhs   Left hand symbol name, it must not be a terminal of the grammar.
+     * @param[in] rhs   Right hand symbol names, epsilon must be alone, and "$" must be the last.
+     * @param[in] id    Id of the new production, the productions from it take the id one more,
+     *                  it can't be the start production. -1 means after all the productions.
+     * @return int      Id of the new production, or -1 if it is not parsed or the production is invalid.
+     */
+    int addProduction(std::string_view lhs, const std::vector<std::string_view> &rhs, int id = -1);
+
+    /**
+     * @brief Remove a production from the parsed grammar, and update the analysis incrementally.
+     *
+     * Only the sets which may shrink are solved again: nillable and first sets of the symbols
+     * whose left corners reach the removed left hand symbol, suffix lists of the productions
+     * using them, and follow sets of the symbols in those productions and whatever includes them.
+     * If the left corners of most nonterminals reach it, the whole grammar is analyzed again.
+     * The productions after it take the id one less.
+     *
+     * @param[in] id    Production id, the start production can't be removed.
+     * @return 0        Pass.
+     * @return other    Not parsed, or invalid id, or it is the last production of a nonterminal
+     *                  which is still used(it would turn into a terminal, which needs a new parse).
+     */
+    int removeProduction(int id);
     bool isValidLL1();
     std::string buildHtmlTable(bool hasProductionTable = true, bool hasLL1Table = true);
 
+    /**
+     * @brief Render the html table into an output sink.
+     *
+     * The html is written piece by piece through the sink's bounded buffer,
+     * so the memory used doesn't scale with the table size.
+     *
+     * @return 0        Pass.
+     * @return other    Not parsed, or failed to write.
+     */
+    int buildHtmlTable(OutputSink &out, bool hasProductionTable = true, bool hasLL1Table = true);
+
+    /**
+     * @brief Generate a standalone recursive-descent parser in C++ into an output sink.
+     *
+     * Every nonterminal becomes a function which switches on the terminal ids,
+     * so the generated parser does no table lookup at runtime.
+     *
+     * @param[out] out          Output sink of the generated header.
+     * @param[in] className     Class name of the generated parser.
+     * @return 0                Pass.
+     * @return other            Not parsed, not LL(1), invalid class name, or failed to write.
+     */
+    int buildCppParser(OutputSink &out, const std::string &className);
+
+    /**
+     * @brief Write the symbols, the productions, their sets and the LL(1) table as compact records.
+     *
+     * Symbols are written once, all the others refer to them by ids. Only the cells which are not
+     * empty are written, they are found from the predict sets, so the size and the time scale with
+     * the non-empty cells instead of the nonterminal x terminal grid. In json:
+     *
+     *     {"symbols":[
+     *     {"id":1,"name":"S","type":"nonterminal","nillable":true,"first":[2],"follow":[3,6]},
+     *     ...],
+     *     "productions":[
+     *     {"id":1,"lhs":1,"rhs":[2,1,3,1],"nillable":false,"first":[2],"predict":[2]},
+     *     ...],
+     *     "table":{"rows":[5,1],"columns":[3,2,6],"cells":[
+     *     [1,2,1],                 nonterminal id, terminal id, production ids(more than one if conflict)
+     *     ...]},
+     *     "ll1":true}
+     *
+     * In csv, the records have the same fields in the same order, the id lists are separated
+     * by spaces, and the booleans are 0 or 1:
+     *
+     *     symbol,1,S,nonterminal,1,2,3 6
+     *     production,1,1,2 1 3 1,0,2,2
+     *     row,0,5                  row index, nonterminal id
+     *     column,0,3               column index, terminal id
+     *     cell,1,2,1
+     *     ll1,1
+     *
+     * @param[out] out      Output sink of the records.
+     * @param[in] format    Format of the records.
+     * @return 0            Pass.
+     * @return other        Not parsed, or failed to write.
+     */
+    int buildRecords(OutputSink &out, RecordFormat format);
+
+    /**
+     * @brief Write the analysis results in a compact binary form.
+     *
+     * Nillable flags, first sets, follow sets, predict sets, and the LL(1) table(by its compressed
+     * form) are written, they are only valid for the same grammar context. Suffix lists are not
+     * written, loadAnalysis() builds them again in one pass.
+     *
+     * @param[out] data     The results are appended to it.
+     * @return int          0 if pass, or the analyzer is not parsed.
+     */
+    int saveAnalysis(std::string &data) const;
+
+    /**
+     * @brief Read the analysis results written by saveAnalysis(), instead of parse().
+     *
+     * Nothing changes if the data is broken or belongs to another grammar.
+     *
+     * @param[in] data      The results.
+     * @return int          0 if pass, and the analyzer is parsed.
+     */
+    int loadAnalysis(std::string_view data);
+
+    /**
+     * @brief Read the analysis results from an opened grammar image, instead of parse().
+     *
+     * The image must be analyzed and of the same grammar context, such as the one built by
+     * GrammarContextBuilder::buildFromImage(). Nothing changes if it isn't.
+     *
+     * @param[in] image     The grammar image.
+     * @return int          0 if pass, and the analyzer is parsed.
+     */
+    int loadAnalysis(const GrammarImage &image);
+
+    /**
+     * @brief Get the LL(1) table, it is built by parse().
+     */
+    const LL1Table &ll1Table() const { return ll1Table_; }
+
+    /**
+     * @brief Get the row displacement compressed LL(1) table, it is built by parse().
+     */
+    const CompressedLL1Table &compressedLL1Table() const { return compressedLL1Table_; }
+
+    /**
+     * @brief Some counters of the analysis, they are used to measure the engines.
+     */
+    struct Statistics {
+        std::size_t nullableVisitCount = 0;    ///< Production visits when computing nillable.
+        std::size_t firstSetVisitCount = 0;    ///< Production visits when computing first set.
+        std::size_t followSetVisitCount = 0;   ///< Production visits when computing follow set.
+        std::size_t incrementalVisitCount = 0; ///< Production visits when updating after an edit.
+    };
+    const Statistics &statistics() const { return statistics_; }
+
 private:
+    void analyze();
     void initEPS();
-    bool isEPS(const SymbolList& symbolList);
     void buildFirstSet();
-    SymbolSet calculateFirstSet(const SymbolList& symbolList);
+    void buildFirstSetByDigraph();
+    void forEachProduction(const std::function<void(const Production &)> &visit);
+    void buildSuffixList();
     void buildFollowSet();
+    void buildFollowSetByFixpoint();
+    void buildFollowSetByDigraph();
+    void buildSuffixList(const Production &p);
     void buildPredictSet();
+    void buildPredictSet(const Production &p);
+    void buildLL1Table();
+    void buildLL1TableHeader(LL1Table &table) const;
+    void fillLL1Table(const Production &p);
+    void updateLL1Table(const std::vector<bool> &isLhsChanged, int from, int delta);
+    bool uniteFirstSetOfRhs(const Production &p);
+    void updateAfterAdding(const Production &p, std::vector<bool> &isLhsChanged);
+
+    /**
+     * @brief Analysis results read by a loadAnalysis(), nothing of the analyzer changes until
+     * all of them are read and checked.
+     */
+    struct LoadedAnalysis {
+        struct SymbolResult {
+            bool isNillable = false;
+            SymbolSet firstSet;
+            SymbolSet followSet;
+        };
+        std::vector<SymbolResult> symbols;                 ///< Symbol id mapping its results.
+        std::vector<Production::RightHandSide> rhsList;    ///< Production id mapping its results.
+        LL1Table table;                                    ///< The cells are expanded from the compressed table.
+        CompressedLL1Table compressed;
+    };
+    static std::size_t expandLL1Table(LoadedAnalysis &analysis);
+    static bool addConflict(LoadedAnalysis &analysis, std::size_t index, std::vector<int> ids);
+    void restoreAnalysis(LoadedAnalysis &analysis);
 
 
     bool setUnion(SymbolSet& set1, SymbolSet& set2);
@@ -34,21 +241,72 @@ private:
 
     GrammarContextPtr gc_;
     bool isParsed_;
+    FollowSetEngine followSetEngine_ = FollowSetEngine::digraph;
+    std::size_t jobs_ = 1;
+    Statistics statistics_;
+    LL1Table ll1Table_;
+    CompressedLL1Table compressedLL1Table_;
 
     class HtmlBuilder{
     public:
-        HtmlBuilder(GrammarContextPtr gc, bool buildProductionTable = true, bool buildLL1Table = true)
-        :gc_(gc), buildProductionTable_(buildProductionTable), buildLL1Table_(buildLL1Table){}
-        std::string buildHtmlTable();
+        HtmlBuilder(GrammarContextPtr gc, const LL1Table &table, OutputSink &out,
+                    bool buildProductionTable = true, bool buildLL1Table = true)
+        :gc_(gc), table_(table), out_(out), buildProductionTable_(buildProductionTable), buildLL1Table_(buildLL1Table){}
+        void buildHtmlTable();
     private:
         GrammarContextPtr gc_;
+        const LL1Table &table_;
+        OutputSink &out_;
         bool buildProductionTable_;
         bool buildLL1Table_;
 
-        std::string buildHtmlHead();
-        std::string buildHtmlBody();
-        std::string buildHtmlTableOfProductionTable();
-        std::string buildHtmlTableOfLL1Table();
+        void buildHtmlHead();
+        void buildHtmlBody();
+        void buildHtmlTableOfProductionTable();
+        void buildHtmlTableOfLL1Table();
+        void formatCell(std::string_view text);
+    };
+
+    class CppBuilder{
+    public:
+        CppBuilder(GrammarContextPtr gc, const LL1Table &table, OutputSink &out, const std::string &className)
+        :gc_(gc), table_(table), out_(out), className_(className){}
+        int buildCppParser();
+    private:
+        GrammarContextPtr gc_;
+        const LL1Table &table_;
+        OutputSink &out_;
+        std::string className_;
+
+        bool isValidClassName() const;
+        void buildFileHead();
+        void buildClass();
+        void buildFunction(std::size_t row);
+        void buildProduction(const Production &p, std::string_view caseIndent, bool isTailLoop);
+        void buildComment(std::string_view text);
+        std::string productionText(const Production &p) const;
+    };
+
+    class RecordBuilder{
+    public:
+        RecordBuilder(GrammarContextPtr gc, const LL1Table &table, OutputSink &out, RecordFormat format)
+        :gc_(gc), table_(table), out_(out), format_(format){}
+        void buildRecords();
+    private:
+        GrammarContextPtr gc_;
+        const LL1Table &table_;
+        OutputSink &out_;
+        RecordFormat format_;
+
+        bool isJson() const { return format_ == RecordFormat::json; }
+        void buildSymbols();
+        void buildProductions();
+        void buildTable();
+        void buildField(std::string_view key, bool isFirst = false);
+        void buildName(std::string_view name);
+        void buildBool(bool value);
+        template <typename Ids>
+        void buildIds(const Ids &ids);
     };
 };
 
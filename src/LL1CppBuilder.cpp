@@ -0,0 +1,200 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LL1Analyzer.h"
+
+#include <cctype>
+
+using namespace csa;
+
+//
+// The generated parser looks like:
+//
+//     class ClassName {
+//     public:
+//         bool parse(const std::size_t *terminals, std::size_t count);
+//         ...
+//     private:
+//         // S
+//         bool parse0() {
+//             while (true) {
+//                 switch (lookahead()) {
+//                 case 5:    // (
+//                     // S -> ( S ) S
+//                     productions_.push_back(1);
+//                     ++it_;
+//                     if (!parse0()) { return false; }
+//                     if (lookahead() != 6) { return false; }
+//                     ++it_;
+//                     continue;
+//                 ...
+//                 default:
+//                     return false;
+//                 }
+//             }
+//         }
+//     };
+//
+// A production ends with its own nonterminal loops instead of calling itself,
+// so a right recursive list doesn't grow the call stack.
+//
+
+int LL1Analyzer::CppBuilder::buildCppParser() {
+    if (!isValidClassName()) {
+        printf("error, invalid class name = %s\n", className_.c_str());
+        return 1;
+    }
+    if (table_.hasConflict()) {
+        printf("error, the grammar is not LL(1), cannot generate parser.\n");
+        return 1;
+    }
+    if (table_.rowCount() == 0) { return 1; }
+
+    buildFileHead();
+    buildClass();
+    return 0;
+}
+
+bool LL1Analyzer::CppBuilder::isValidClassName() const {
+    if (className_.empty() || std::isdigit(static_cast<unsigned char>(className_.front()))) { return false; }
+    for (auto c : className_) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') { return false; }
+    }
+    return true;
+}
+
+void LL1Analyzer::CppBuilder::buildFileHead() {
+    out_ << "//\n";
+    out_ << "// LL(1) recursive-descent parser generated by cpp-syntax-analyzer, do not edit.\n";
+    out_ << "//\n";
+    out_ << "// Input is a stream of terminal ids which ends with the eof terminal,\n";
+    out_ << "// they are the symbol ids of the grammar:\n";
+    for (auto t : table_.terminals) {
+        out_ << "//   " << t->id() << " ";
+        buildComment(t->name());
+    }
+    out_ << "//\n";
+    out_ << "// Every nonterminal is a function, so the nesting depth of the input is bounded by the call stack.\n";
+    out_ << "//\n\n";
+    out_ << "#pragma once\n\n";
+    out_ << "#include <cstddef>\n";
+    out_ << "#include <vector>\n\n";
+}
+
+void LL1Analyzer::CppBuilder::buildClass() {
+    auto start = table_.rowOfSymbol[gc_->pl->table().front().lhs.symbol->id()];
+
+    out_ << "class " << className_ << " {\n";
+    out_ << "public:\n";
+    out_ << "    /// Parse the terminals, return true if they are accepted.\n";
+    out_ << "    bool parse(const std::size_t *terminals, std::size_t count) {\n";
+    out_ << "        begin_ = it_ = terminals;\n";
+    out_ << "        end_ = terminals + count;\n";
+    out_ << "        productions_.clear();\n";
+    out_ << "        return parse" << start << "();\n";
+    out_ << "    }\n\n";
+    out_ << "    bool parse(const std::vector<std::size_t> &terminals) { return parse(terminals.data(), terminals.size()); }\n\n";
+    out_ << "    /// Get the count of the consumed terminals, it is the error position if rejected.\n";
+    out_ << "    std::size_t consumedCount() const { return static_cast<std::size_t>(it_ - begin_); }\n\n";
+    out_ << "    /// Get the applied production ids in order.\n";
+    out_ << "    const std::vector<int> &productions() const { return productions_; }\n\n";
+    out_ << "private:\n";
+    out_ << "    static constexpr std::size_t npos = static_cast<std::size_t>(-1);\n\n";
+    out_ << "    std::size_t lookahead() const { return it_ < end_ ? *it_ : npos; }\n";
+
+    for (std::size_t row = 0; row < table_.rowCount(); ++row) { buildFunction(row); }
+
+    out_ << "\n";
+    out_ << "    const std::size_t *begin_ = nullptr;\n";
+    out_ << "    const std::size_t *it_ = nullptr;\n";
+    out_ << "    const std::size_t *end_ = nullptr;\n";
+    out_ << "    std::vector<int> productions_;\n";
+    out_ << "};\n";
+}
+
+void LL1Analyzer::CppBuilder::buildFunction(std::size_t row) {
+    auto &pl = gc_->pl->table();
+    auto nonterminal = table_.nonterminals[row];
+
+    // Group the columns by production, productions are in id order.
+    std::map<int, std::vector<std::size_t>> columnsOfProduction;
+    for (std::size_t column = 0; column < table_.columnCount(); ++column) {
+        auto cell = table_.at(row, column);
+        if (cell != LL1Table::emptyCell) { columnsOfProduction[cell].push_back(column); }
+    }
+
+    bool hasTailLoop = false;
+    for (auto &[pid, columns] : columnsOfProduction) {
+        auto &symbolList = pl[pid].rhs.symbolList;
+        if (!symbolList.empty() && symbolList.back() == nonterminal) { hasTailLoop = true; }
+    }
+
+    std::string_view indent = hasTailLoop ? "            " : "        ";
+    out_ << "\n";
+    out_ << "    // ";
+    buildComment(nonterminal->name());
+    out_ << "    bool parse" << row << "() {\n";
+    if (hasTailLoop) { out_ << "        while (true) {\n"; }
+    out_ << indent << "switch (lookahead()) {\n";
+    for (auto &[pid, columns] : columnsOfProduction) {
+        for (auto column : columns) {
+            auto t = table_.terminals[column];
+            out_ << indent << "case " << t->id() << ":    // ";
+            buildComment(t->name());
+        }
+        auto &p = pl[pid];
+        auto &symbolList = p.rhs.symbolList;
+        buildProduction(p, indent, hasTailLoop && !symbolList.empty() && symbolList.back() == nonterminal);
+    }
+    out_ << indent << "default:\n";
+    out_ << indent << "    return false;\n";
+    out_ << indent << "}\n";
+    if (hasTailLoop) { out_ << "        }\n"; }
+    out_ << "    }\n";
+}
+
+void LL1Analyzer::CppBuilder::buildProduction(const Production &p, std::string_view caseIndent, bool isTailLoop) {
+    std::string indent(caseIndent);
+    indent += "    ";
+    out_ << indent << "// ";
+    buildComment(productionText(p));
+    out_ << indent << "productions_.push_back(" << static_cast<std::size_t>(p.id) << ");\n";
+
+    auto &symbolList = p.rhs.symbolList;
+    auto size = isTailLoop ? symbolList.size() - 1 : symbolList.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        auto symbol = symbolList[i];
+        if (symbol->isTerminalEpsilon()) { continue; }
+        if (symbol->isNonterminal()) {
+            out_ << indent << "if (!parse" << table_.rowOfSymbol[symbol->id()] << "()) { return false; }\n";
+        } else {
+            // The switch has matched the first terminal already.
+            if (i != 0) { out_ << indent << "if (lookahead() != " << symbol->id() << ") { return false; }\n"; }
+            out_ << indent << "++it_;\n";
+        }
+    }
+    out_ << indent << (isTailLoop ? "continue;\n" : "return true;\n");
+}
+
+void LL1Analyzer::CppBuilder::buildComment(std::string_view text) {
+    out_ << text;
+    // A comment ends with a backslash would splice the next line.
+    if (!text.empty() && text.back() == '\\') { out_ << " //"; }
+    out_ << "\n";
+}
+
+std::string LL1Analyzer::CppBuilder::productionText(const Production &p) const {
+    std::string text(p.lhs.symbol->name());
+    text += " ->";
+    for (auto symbol : p.rhs.symbolList) {
+        text += " ";
+        text += symbol->name();
+    }
+    return text;
+}
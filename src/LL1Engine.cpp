@@ -0,0 +1,86 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LL1Engine.h"
+
+using namespace csa;
+
+LL1Engine::LL1Engine(GrammarContextPtr gc, const LL1Table &table, std::size_t stackCapacity)
+    : table_(table) {
+    auto toEntry = [&](SymbolPtr symbol) {
+        if (symbol->isNonterminal()) {
+            // A nonterminal without a row would be read as the terminal of column 0.
+            assert(table_.rowOfSymbol[symbol->id()] != LL1Table::npos);
+            return ~static_cast<Entry>(table_.rowOfSymbol[symbol->id()]);
+        }
+        return static_cast<Entry>(table_.columnOfSymbol[symbol->id()]);
+    };
+
+    auto &pl = gc->pl->table();
+    rhsBegin_.assign(pl.size() + 1, 0);
+    for (auto &p : pl) {
+        rhsBegin_[p.id] = rhsEntries_.size();
+        auto &symbolList = p.rhs.symbolList;
+        for (auto rbeg = symbolList.rbegin(); rbeg < symbolList.rend(); ++rbeg) {
+            if (!(*rbeg)->isTerminalEpsilon()) { rhsEntries_.push_back(toEntry(*rbeg)); }
+        }
+    }
+    rhsBegin_[pl.size()] = rhsEntries_.size();
+    startEntry_ = toEntry(pl.front().lhs.symbol);
+
+    stack_.reserve(stackCapacity);
+    reset();
+}
+
+void LL1Engine::reset() {
+    stack_.clear();
+    stack_.push_back(startEntry_);
+    productions_.clear();
+    status_ = Status::running;
+    consumedCount_ = 0;
+}
+
+LL1Engine::Status LL1Engine::push(SymbolId terminal) {
+    if (status_ != Status::running) { return status_; }
+
+    auto column = terminal < table_.columnOfSymbol.size() ? table_.columnOfSymbol[terminal] : LL1Table::npos;
+    if (column == LL1Table::npos) { return status_ = Status::rejected; }
+
+    auto columnCount = table_.columnCount();
+    auto cells = table_.cells.data();
+
+    while (!stack_.empty()) {
+        auto top = stack_.back();
+
+        // Match a terminal.
+        if (top >= 0) {
+            if (static_cast<std::size_t>(top) != column) { break; }
+            stack_.pop_back();
+            ++consumedCount_;
+            if (stack_.empty()) { status_ = Status::accepted; }
+            return status_;
+        }
+
+        // Expand a nonterminal.
+        auto row = static_cast<std::size_t>(~top);
+        auto cell = cells[row * columnCount + column];
+        if (cell < 0) { break; }    // Empty cell, or conflict cell which cannot be decided.
+        stack_.pop_back();
+        stack_.insert(stack_.end(), rhsEntries_.begin() + rhsBegin_[cell], rhsEntries_.begin() + rhsBegin_[cell + 1]);
+        productions_.push_back(cell);
+    }
+
+    return status_ = Status::rejected;
+}
+
+LL1Engine::Status LL1Engine::parse(const SymbolId *terminals, std::size_t count) {
+    reset();
+    for (std::size_t i = 0; i < count && status_ == Status::running; ++i) { push(terminals[i]); }
+    return status_;
+}
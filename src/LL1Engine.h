@@ -0,0 +1,83 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+
+namespace csa {
+
+/**
+ * @brief A table-driven LL(1) parse engine.
+ *
+ * It runs a LL(1) table produced by LL1Analyzer over a stream of terminal ids(symbol ids),
+ * and emits accept or reject, plus the applied production sequence(a leftmost derivation).
+ * The input stream must end with the eof terminal. Reaching a conflict cell rejects the input,
+ * since a table with conflicts is not LL(1), and it may even be left recursive.
+ *
+ * The stack is preallocated and reused by every parse, the table must outlive the engine.
+ */
+class LL1Engine {
+public:
+    static constexpr std::size_t defaultStackCapacity = 1024;
+
+    enum class Status : int {
+        running = 0,    ///< Waiting for more terminals.
+        accepted,       ///< The input is accepted.
+        rejected        ///< The input is rejected.
+    };
+
+    LL1Engine(GrammarContextPtr gc, const LL1Table &table, std::size_t stackCapacity = defaultStackCapacity);
+
+    /**
+     * @brief Reset the engine for a new input, the allocated memory is kept.
+     */
+    void reset();
+
+    /**
+     * @brief Consume one terminal.
+     *
+     * @param[in] terminal  Input terminal id.
+     * @return Status       The status after the terminal is consumed.
+     */
+    Status push(SymbolId terminal);
+
+    /**
+     * @brief Reset the engine, and consume all the terminals.
+     */
+    Status parse(const SymbolId *terminals, std::size_t count);
+    Status parse(const std::vector<SymbolId> &terminals) { return parse(terminals.data(), terminals.size()); }
+
+    Status status() const { return status_; }
+
+    /**
+     * @brief Get the count of the consumed terminals, it is the error position if rejected.
+     */
+    std::size_t consumedCount() const { return consumedCount_; }
+
+    /**
+     * @brief Get the applied production ids in order.
+     */
+    const std::vector<int> &productions() const { return productions_; }
+
+private:
+    /// A stack entry is a terminal column(>= 0), or the bitwise not of a nonterminal row(< 0).
+    using Entry = std::int32_t;
+
+    const LL1Table &table_;
+    std::vector<std::size_t> rhsBegin_;    ///< Production id mapping its begin in rhsEntries_.
+    std::vector<Entry> rhsEntries_;        ///< Right hand sides in reversed order, without epsilon.
+    Entry startEntry_ = 0;                 ///< The start symbol.
+    std::vector<Entry> stack_;
+    std::vector<int> productions_;
+    Status status_ = Status::running;
+    std::size_t consumedCount_ = 0;
+};
+
+}    // namespace csa
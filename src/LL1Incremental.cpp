@@ -0,0 +1,467 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LL1Analyzer.h"
+#include "Digraph.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace csa;
+
+namespace {
+
+/**
+ * @brief Symbol id mapping the productions it occurs in(once per occurrence).
+ */
+std::vector<std::vector<std::size_t>> occurrencesOf(const ProductionList &pl, std::size_t symbolCount) {
+    std::vector<std::vector<std::size_t>> occurrences(symbolCount);
+    for (auto &p : pl) {
+        for (auto &symbol : p.rhs.symbolList) { occurrences[symbol->id()].push_back(p.id); }
+    }
+    return occurrences;
+}
+
+/**
+ * @brief Symbol id mapping the productions whose first set depends on it.
+ */
+std::vector<std::vector<std::size_t>> leftCornerUsersOf(const ProductionList &pl, std::size_t symbolCount) {
+    std::vector<std::vector<std::size_t>> leftCornerUsers(symbolCount);
+    for (auto &p : pl) {
+        for (auto &symbol : p.rhs.symbolList) {
+            if (symbol->isNonterminal()) { leftCornerUsers[symbol->id()].push_back(p.id); }
+            if (!symbol->isNillable()) { break; }
+        }
+    }
+    return leftCornerUsers;
+}
+
+/**
+ * @brief Symbol id mapping the symbols which include its follow set.
+ *
+ * For production A -> xBy where y is nillable, Follow(B) includes Follow(A).
+ */
+std::vector<std::vector<SymbolId>> includedByOf(const ProductionList &pl, std::size_t symbolCount) {
+    std::vector<std::vector<SymbolId>> includedBy(symbolCount);
+    for (auto &p : pl) {
+        auto &symbolList = p.rhs.symbolList;
+        for (std::size_t i = 0; i < symbolList.size(); ++i) {
+            if (symbolList[i]->isNonterminal() && p.rhs.suffixList[i + 1].isNillable) {
+                includedBy[p.lhs.symbol->id()].push_back(symbolList[i]->id());
+            }
+        }
+    }
+    return includedBy;
+}
+
+bool isRhsNillable(const Production &p) {
+    for (auto &symbol : p.rhs.symbolList) {
+        if (!symbol->isTerminalEpsilon() && !symbol->isNillable()) { return false; }
+    }
+    return true;
+}
+
+}    // namespace
+
+int LL1Analyzer::addProduction(std::string_view lhs, const std::vector<std::string_view> &rhs, int id) {
+    if (!isParsed_) { return -1; }
+    if (id == -1) { id = static_cast<int>(gc_->pl->table().size()); }
+    if (id <= 0 || id > static_cast<int>(gc_->pl->table().size())) {
+        printf("[LL1Analyzer::addProduction]\n");
+        printf("  [error] invalid production id [%d]\n", id);
+        return -1;
+    }
+
+    auto &st = *gc_->st;
+    auto error = [&](const char *message, std::string_view name) {
+        printf("[LL1Analyzer::addProduction]\n");
+        printf("  [error] %s [%.*s]\n", message, static_cast<int>(name.size()), name.data());
+        return -1;
+    };
+
+    if (lhs.empty() || rhs.empty()) { return error("empty production side", lhs); }
+    if (lhs == config::keyword::eof || lhs == config::keyword::epsilon || lhs == config::keyword::alien) {
+        return error("left hand side of production cannot use", lhs);
+    }
+    for (std::size_t i = 0; i < rhs.size(); ++i) {
+        auto name = rhs[i];
+        if (name.empty() || name == config::keyword::alien) { return error("right hand side cannot use", name); }
+        if (name == config::keyword::epsilon && rhs.size() != 1) {
+            return error("cannot use epsilon with other tokens at right hand side", name);
+        }
+        if (name == config::keyword::eof && i + 1 != rhs.size()) {
+            return error("cannot use eof at the middle of right hand side", name);
+        }
+    }
+
+    // A terminal of the grammar turning into a nonterminal changes every set, it needs a new parse.
+    auto lhsSymbol = st.findSymbol(lhs);
+    if (lhsSymbol->isTerminal()) { return error("left hand side is a terminal of the grammar", lhs); }
+
+    Production p;
+    p.lhs.symbol = lhsSymbol;
+    for (auto name : rhs) { p.rhs.symbolList.push_back(st.findSymbol(name)); }
+    for (auto &q : gc_->pl->table()) {
+        if (q == p) { return error("the production exists, its left hand side is", lhs); }
+    }
+
+    lhsSymbol->setType(Symbol::Type::nonterminal);
+    for (auto &symbol : p.rhs.symbolList) {
+        if (symbol->name() == config::keyword::eof) {
+            symbol->setType(Symbol::Type::terminalIsEof);
+        } else if (symbol->getType() == Symbol::Type::unknown) {
+            symbol->setType(Symbol::Type::terminal);
+        }
+        if (symbol->isTerminal() && symbol->firstSet().empty() && !symbol->isTerminalEpsilon()) {
+            symbol->firstSet().insert(symbol->id());
+        }
+    }
+
+    auto &added = gc_->pl->insert(static_cast<std::size_t>(id), std::move(p));
+    std::vector<bool> isLhsChanged;
+    updateAfterAdding(added, isLhsChanged);
+    updateLL1Table(isLhsChanged, id, 1);
+
+    return added.id;
+}
+
+bool LL1Analyzer::uniteFirstSetOfRhs(const Production &p) {
+    // Sets are kept without epsilon, so epsilon adds nothing.
+    bool hasChange = false;
+    for (auto &symbol : p.rhs.symbolList) {
+        if (symbol->isTerminalEpsilon()) { break; }
+        if (setUnion(p.lhs.symbol->firstSet(), symbol->firstSet())) { hasChange = true; }
+        if (!symbol->isNillable()) { break; }
+    }
+    return hasChange;
+}
+
+void LL1Analyzer::updateAfterAdding(const Production &p, std::vector<bool> &isLhsChanged) {
+    auto &pl = gc_->pl->table();
+    auto symbolCount = gc_->st->symbolCount();
+    auto epsilon = gc_->st->findSymbol(config::keyword::epsilon);
+    auto occurrences = occurrencesOf(pl, symbolCount);
+
+    // Nillable grows from the new production.
+    std::vector<SymbolPtr> newlyNillable;
+    auto checkNillable = [&](const Production &q) {
+        ++statistics_.incrementalVisitCount;
+        if (q.rhs.isNillable || !isRhsNillable(q)) { return; }
+        q.rhs.isNillable = true;
+        if (!q.lhs.symbol->isNillable()) {
+            q.lhs.symbol->setNillable(true);
+            newlyNillable.push_back(q.lhs.symbol);
+        }
+    };
+    checkNillable(p);
+    for (std::size_t i = 0; i < newlyNillable.size(); ++i) {
+        for (auto id : occurrences[newlyNillable[i]->id()]) { checkNillable(pl[id]); }
+    }
+
+    // First sets grow from the new production, and the productions whose left corners
+    // get longer by the newly nillable symbols.
+    auto leftCornerUsers = leftCornerUsersOf(pl, symbolCount);
+    std::deque<std::size_t> worklist;
+    std::vector<bool> isQueued(pl.size(), false);
+    auto push = [&](std::size_t id) {
+        if (!isQueued[id]) {
+            isQueued[id] = true;
+            worklist.push_back(id);
+        }
+    };
+    push(p.id);
+    for (auto symbol : newlyNillable) {
+        for (auto id : occurrences[symbol->id()]) { push(id); }
+    }
+
+    std::vector<bool> isChanged(symbolCount, false);
+    std::vector<SymbolPtr> changed(newlyNillable);
+    for (auto symbol : newlyNillable) { isChanged[symbol->id()] = true; }
+    while (!worklist.empty()) {
+        auto &q = pl[worklist.front()];
+        isQueued[worklist.front()] = false;
+        worklist.pop_front();
+        ++statistics_.incrementalVisitCount;
+
+        if (uniteFirstSetOfRhs(q)) {
+            if (!isChanged[q.lhs.symbol->id()]) {
+                isChanged[q.lhs.symbol->id()] = true;
+                changed.push_back(q.lhs.symbol);
+            }
+            for (auto id : leftCornerUsers[q.lhs.symbol->id()]) { push(id); }
+        }
+    }
+
+    // Suffix lists of the new production and the productions using a changed symbol.
+    std::vector<std::size_t> dirty;
+    std::vector<bool> isDirty(pl.size(), false);
+    auto markDirty = [&](std::size_t id) {
+        if (!isDirty[id]) {
+            isDirty[id] = true;
+            dirty.push_back(id);
+        }
+    };
+    markDirty(p.id);
+    for (auto symbol : changed) {
+        for (auto id : occurrences[symbol->id()]) { markDirty(id); }
+    }
+    for (auto id : dirty) {
+        ++statistics_.incrementalVisitCount;
+        buildSuffixList(pl[id]);
+        for (auto &suffix : pl[id].rhs.suffixList) { setRemove(suffix.firstSet, epsilon); }
+    }
+
+    // Follow sets grow from the dirty productions, then along the inclusions.
+    auto includedBy = includedByOf(pl, symbolCount);
+    std::vector<bool> isFollowChanged(symbolCount, false);
+    std::vector<SymbolPtr> followWorklist;
+    auto growFollow = [&](SymbolPtr symbol, SymbolSet &set) {
+        if (setUnion(symbol->followSet(), set)) {
+            isFollowChanged[symbol->id()] = true;
+            followWorklist.push_back(symbol);
+        }
+    };
+    for (auto id : dirty) {
+        auto &q = pl[id];
+        for (std::size_t i = 0; i < q.rhs.symbolList.size(); ++i) {
+            auto symbol = q.rhs.symbolList[i];
+            if (!symbol->isNonterminal()) { continue; }
+            auto &tail = q.rhs.suffixList[i + 1];
+            growFollow(symbol, tail.firstSet);
+            if (tail.isNillable) { growFollow(symbol, q.lhs.symbol->followSet()); }
+        }
+    }
+    while (!followWorklist.empty()) {
+        auto symbol = followWorklist.back();
+        followWorklist.pop_back();
+        for (auto id : includedBy[symbol->id()]) { growFollow(gc_->st->getSymbol(id), symbol->followSet()); }
+    }
+
+    // Predict sets of the dirty productions, and the nillable productions whose follow set grows.
+    isLhsChanged.assign(symbolCount, false);
+    for (auto &q : pl) {
+        if (isDirty[q.id] || (q.rhs.isNillable && isFollowChanged[q.lhs.symbol->id()])) {
+            ++statistics_.incrementalVisitCount;
+            buildPredictSet(q);
+            isLhsChanged[q.lhs.symbol->id()] = true;
+        }
+    }
+}
+
+int LL1Analyzer::removeProduction(int id) {
+    if (!isParsed_ || id <= 0 || id >= static_cast<int>(gc_->pl->table().size())) { return 1; }
+
+    // A nonterminal without productions which is still used turns into a terminal of the grammar,
+    // that changes every set like a terminal turning into a nonterminal, it needs a new parse.
+    {
+        auto &pl = gc_->pl->table();
+        auto lhs = pl[id].lhs.symbol;
+        auto isOther = [&](const Production &q) { return q.id != id; };
+        auto isUsed = [&](const Production &q) {
+            auto &symbolList = q.rhs.symbolList;
+            return isOther(q) && std::find(symbolList.begin(), symbolList.end(), lhs) != symbolList.end();
+        };
+        auto hasOther = [&](const Production &q) { return isOther(q) && q.lhs.symbol == lhs; };
+        if (std::none_of(pl.begin(), pl.end(), hasOther) && std::any_of(pl.begin(), pl.end(), isUsed)) {
+            printf("[LL1Analyzer::removeProduction]\n");
+            printf("  [error] the last production of a used nonterminal [%.*s]\n", static_cast<int>(lhs->name().size()),
+                   lhs->name().data());
+            return 1;
+        }
+    }
+
+    auto &st = *gc_->st;
+    auto symbolCount = st.symbolCount();
+    auto epsilon = st.findSymbol(config::keyword::epsilon);
+
+    // The cone is the symbols whose left corners reach the removed left hand side, only their
+    // nillable and first sets may shrink. It is found on the old relations before removing.
+    std::vector<SymbolId> cone;
+    std::vector<bool> isInCone(symbolCount, false);
+    std::vector<bool> isLhsChanged(symbolCount, false);
+    std::vector<std::vector<SymbolId>> includedBy;
+    std::vector<SymbolId> followCone;
+    std::vector<bool> isInFollowCone(symbolCount, false);
+    auto addToFollowCone = [&](SymbolPtr symbol) {
+        if (symbol->isNonterminal() && !isInFollowCone[symbol->id()]) {
+            isInFollowCone[symbol->id()] = true;
+            followCone.push_back(symbol->id());
+        }
+    };
+    {
+        auto &pl = gc_->pl->table();
+        auto &removed = pl[id];
+        std::vector<std::vector<SymbolId>> leftCornerOf(symbolCount);
+        for (auto &q : pl) {
+            for (auto &symbol : q.rhs.symbolList) {
+                if (symbol->isNonterminal()) { leftCornerOf[symbol->id()].push_back(q.lhs.symbol->id()); }
+                if (!symbol->isNillable()) { break; }
+            }
+        }
+        isInCone[removed.lhs.symbol->id()] = true;
+        cone.push_back(removed.lhs.symbol->id());
+        for (std::size_t i = 0; i < cone.size(); ++i) {
+            for (auto user : leftCornerOf[cone[i]]) {
+                if (!isInCone[user]) {
+                    isInCone[user] = true;
+                    cone.push_back(user);
+                }
+            }
+        }
+
+        // Solving most of the grammar in the cone costs more than a new analysis.
+        if (cone.size() * 2 > ll1Table_.rowCount()) {
+            gc_->pl->erase(static_cast<std::size_t>(id));
+            for (auto &symbol : st.table()) {
+                symbol->setNillable(false);
+                symbol->followSet().clear();
+            }
+            for (auto &q : gc_->pl->table()) { q.rhs.isNillable = false; }
+            analyze();
+            return 0;
+        }
+
+        // The old inclusions cover the new ones, since nillable only shrinks.
+        includedBy = includedByOf(pl, symbolCount);
+        for (auto &symbol : removed.rhs.symbolList) { addToFollowCone(symbol); }
+        isLhsChanged[removed.lhs.symbol->id()] = true;
+    }
+
+    gc_->pl->erase(static_cast<std::size_t>(id));
+    auto &pl = gc_->pl->table();
+    auto occurrences = occurrencesOf(pl, symbolCount);
+
+    // Solve nillable of the cone by counting like initEPS(), the symbols out of it are fixed.
+    std::vector<std::pair<bool, SymbolSet>> old;
+    for (auto symbol : cone) {
+        auto theSymbol = st.getSymbol(symbol);
+        old.emplace_back(theSymbol->isNillable(), std::move(theSymbol->firstSet()));
+        theSymbol->setNillable(false);
+        theSymbol->firstSet().clear();
+    }
+    std::vector<std::size_t> coneProductions;
+    std::vector<std::size_t> remainCount(pl.size(), 0);
+    std::vector<SymbolPtr> worklist;
+    auto setNillable = [&](SymbolPtr symbol) {
+        if (!symbol->isNillable()) {
+            symbol->setNillable(true);
+            worklist.push_back(symbol);
+        }
+    };
+    for (auto &q : pl) {
+        if (!isInCone[q.lhs.symbol->id()]) { continue; }
+        ++statistics_.incrementalVisitCount;
+        coneProductions.push_back(q.id);
+        for (auto &symbol : q.rhs.symbolList) {
+            if (!symbol->isTerminalEpsilon() && !symbol->isNillable()) { ++remainCount[q.id]; }
+        }
+    }
+    for (auto i : coneProductions) {
+        if (remainCount[i] == 0) { setNillable(pl[i].lhs.symbol); }
+    }
+    while (!worklist.empty()) {
+        auto symbol = worklist.back();
+        worklist.pop_back();
+        for (auto i : occurrences[symbol->id()]) {
+            if (!isInCone[pl[i].lhs.symbol->id()]) { continue; }
+            ++statistics_.incrementalVisitCount;
+            if (--remainCount[i] == 0) { setNillable(pl[i].lhs.symbol); }
+        }
+    }
+
+    // Solve first sets of the cone by a worklist, the sets out of it are fixed.
+    auto leftCornerUsers = leftCornerUsersOf(pl, symbolCount);
+    std::deque<std::size_t> queue(coneProductions.begin(), coneProductions.end());
+    std::vector<bool> isQueued(pl.size(), false);
+    for (auto i : coneProductions) { isQueued[i] = true; }
+    while (!queue.empty()) {
+        auto &q = pl[queue.front()];
+        isQueued[queue.front()] = false;
+        queue.pop_front();
+        ++statistics_.incrementalVisitCount;
+
+        if (uniteFirstSetOfRhs(q)) {
+            for (auto user : leftCornerUsers[q.lhs.symbol->id()]) {
+                if (isInCone[pl[user].lhs.symbol->id()] && !isQueued[user]) {
+                    isQueued[user] = true;
+                    queue.push_back(user);
+                }
+            }
+        }
+    }
+
+    // Only the productions using a changed symbol get new suffix lists, and the nonterminals
+    // in them seed the follow cone.
+    std::vector<bool> isTouched(pl.size(), false);
+    for (std::size_t i = 0; i < cone.size(); ++i) {
+        auto symbol = st.getSymbol(cone[i]);
+        if (old[i].first == symbol->isNillable() && old[i].second == symbol->firstSet()) { continue; }
+        for (auto j : occurrences[cone[i]]) {
+            if (isTouched[j]) { continue; }
+            isTouched[j] = true;
+            ++statistics_.incrementalVisitCount;
+            auto &q = pl[j];
+            q.rhs.isNillable = isRhsNillable(q);
+            buildSuffixList(q);
+            for (auto &suffix : q.rhs.suffixList) { setRemove(suffix.firstSet, epsilon); }
+            for (auto &theSymbol : q.rhs.symbolList) { addToFollowCone(theSymbol); }
+        }
+    }
+
+    // Follow sets of the follow cone and whatever includes them are solved by the digraph,
+    // the sets out of it are fixed.
+    for (std::size_t i = 0; i < followCone.size(); ++i) {
+        for (auto symbol : includedBy[followCone[i]]) { addToFollowCone(st.getSymbol(symbol)); }
+    }
+    std::vector<std::size_t> localOf(symbolCount, 0);
+    for (std::size_t i = 0; i < followCone.size(); ++i) { localOf[followCone[i]] = i; }
+    Relation includes(followCone.size());
+    std::vector<SymbolSet> sets(followCone.size());
+    std::vector<bool> isVisited(pl.size(), false);
+    for (auto symbol : followCone) {
+        for (auto i : occurrences[symbol]) {
+            if (isVisited[i]) { continue; }
+            isVisited[i] = true;
+            ++statistics_.incrementalVisitCount;
+
+            auto &q = pl[i];
+            auto lhs = q.lhs.symbol;
+            for (std::size_t k = 0; k < q.rhs.symbolList.size(); ++k) {
+                auto theSymbol = q.rhs.symbolList[k];
+                if (!theSymbol->isNonterminal() || !isInFollowCone[theSymbol->id()]) { continue; }
+                auto &set = sets[localOf[theSymbol->id()]];
+                auto &tail = q.rhs.suffixList[k + 1];
+                setUnion(set, tail.firstSet);
+                if (!tail.isNillable) { continue; }
+                if (isInFollowCone[lhs->id()]) {
+                    includes[localOf[theSymbol->id()]].push_back(localOf[lhs->id()]);
+                } else {
+                    setUnion(set, lhs->followSet());
+                }
+            }
+        }
+    }
+    digraph(includes, sets);
+    for (std::size_t i = 0; i < followCone.size(); ++i) {
+        st.getSymbol(followCone[i])->followSet() = std::move(sets[i]);
+    }
+
+    // Predict sets of the touched productions, and the productions whose follow set may change.
+    for (auto &q : pl) {
+        if (isTouched[q.id] || isInFollowCone[q.lhs.symbol->id()]) {
+            ++statistics_.incrementalVisitCount;
+            buildPredictSet(q);
+            isLhsChanged[q.lhs.symbol->id()] = true;
+        }
+    }
+
+    updateLL1Table(isLhsChanged, id + 1, -1);
+
+    return 0;
+}
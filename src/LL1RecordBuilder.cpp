@@ -0,0 +1,227 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LL1Analyzer.h"
+
+using namespace csa;
+
+namespace {
+
+std::string_view typeName(Symbol::Type type) {
+    switch (type) {
+        case Symbol::Type::nonterminal:
+            return "nonterminal";
+        case Symbol::Type::terminal:
+            return "terminal";
+        case Symbol::Type::terminalIsEof:
+            return "eof";
+        case Symbol::Type::terminalIsEpsilon:
+            return "epsilon";
+        default:
+            return "unknown";
+    }
+}
+
+std::size_t idOf(SymbolPtr symbol) { return symbol->id(); }
+std::size_t idOf(std::size_t id) { return id; }
+
+}    // namespace
+
+void LL1Analyzer::RecordBuilder::buildRecords() {
+    if (isJson()) { out_ << '{'; }
+    buildSymbols();
+    buildProductions();
+    buildTable();
+}
+
+void LL1Analyzer::RecordBuilder::buildSymbols() {
+    if (isJson()) { out_ << "\"symbols\":["; }
+    bool isFirst = true;
+    for (auto symbol : gc_->st->table()) {
+        if (symbol->isAlienSymbol()) { continue; }
+        if (isJson()) {
+            out_ << (isFirst ? "\n{" : ",\n{");
+        } else {
+            out_ << "symbol";
+        }
+        isFirst = false;
+        buildField("id", true);
+        out_ << symbol->id();
+        buildField("name");
+        buildName(symbol->name());
+        buildField("type");
+        buildName(typeName(symbol->getType()));
+        buildField("nillable");
+        buildBool(symbol->isNillable());
+        buildField("first");
+        buildIds(symbol->firstSet());
+        buildField("follow");
+        buildIds(symbol->followSet());
+        out_ << (isJson() ? '}' : '\n');
+    }
+    if (isJson()) { out_ << "\n],\n"; }
+}
+
+void LL1Analyzer::RecordBuilder::buildProductions() {
+    if (isJson()) { out_ << "\"productions\":["; }
+    bool isFirst = true;
+    for (auto &p : gc_->pl->table()) {
+        if (isJson()) {
+            out_ << (isFirst ? "\n{" : ",\n{");
+        } else {
+            out_ << "production";
+        }
+        isFirst = false;
+        buildField("id", true);
+        out_ << static_cast<std::size_t>(p.id);
+        buildField("lhs");
+        out_ << p.lhs.symbol->id();
+        buildField("rhs");
+        buildIds(p.rhs.symbolList);
+        buildField("nillable");
+        buildBool(p.rhs.isNillable);
+        buildField("first");
+        buildIds(p.rhs.firstSet);
+        buildField("predict");
+        buildIds(p.rhs.predictSet);
+        out_ << (isJson() ? '}' : '\n');
+    }
+    if (isJson()) { out_ << "\n],\n"; }
+}
+
+void LL1Analyzer::RecordBuilder::buildTable() {
+    if (isJson()) {
+        out_ << "\"table\":{\"rows\":";
+        buildIds(table_.nonterminals);
+        out_ << ",\"columns\":";
+        buildIds(table_.terminals);
+        out_ << ",\"cells\":[";
+    } else {
+        for (std::size_t row = 0; row < table_.rowCount(); ++row) {
+            out_ << "row," << row << ',' << table_.nonterminals[row]->id() << '\n';
+        }
+        for (std::size_t column = 0; column < table_.columnCount(); ++column) {
+            out_ << "column," << column << ',' << table_.terminals[column]->id() << '\n';
+        }
+    }
+
+    // The cells of a row are the terminals of its productions' predict sets, so the grid is never scanned.
+    std::vector<std::vector<const Production *>> productionsOfRow(table_.rowCount());
+    for (auto &p : gc_->pl->table()) { productionsOfRow[table_.rowOfSymbol[p.lhs.symbol->id()]].push_back(&p); }
+
+    // Cells are written in row major order, the same order as the conflicts, so they are walked together.
+    bool isFirst = true;
+    std::vector<std::size_t> columns;
+    auto conflict = table_.conflicts.begin();
+    for (std::size_t row = 0; row < table_.rowCount(); ++row) {
+        columns.clear();
+        for (auto p : productionsOfRow[row]) {
+            for (auto id : p->rhs.predictSet) {
+                auto column = table_.columnOfSymbol[id];
+                if (column != LL1Table::npos) { columns.push_back(column); }
+            }
+        }
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+        auto nonterminal = table_.nonterminals[row]->id();
+        for (auto column : columns) {
+            auto cell = table_.at(row, column);
+            if (cell == LL1Table::emptyCell) { continue; }
+            if (isJson()) {
+                out_ << (isFirst ? "\n[" : ",\n[");
+            } else {
+                out_ << "cell,";
+            }
+            isFirst = false;
+            out_ << nonterminal << ',' << table_.terminals[column]->id() << ',';
+            if (cell == LL1Table::conflictCell) {
+                while (conflict->first < table_.cellIndex(row, column)) { ++conflict; }
+                bool isFirstId = true;
+                for (auto id : conflict->second) {
+                    if (!isFirstId) { out_ << (isJson() ? ',' : ' '); }
+                    isFirstId = false;
+                    out_ << static_cast<std::size_t>(id);
+                }
+            } else {
+                out_ << static_cast<std::size_t>(cell);
+            }
+            out_ << (isJson() ? ']' : '\n');
+        }
+    }
+
+    if (isJson()) {
+        out_ << "\n]},\n\"ll1\":";
+        buildBool(!table_.hasConflict());
+        out_ << "}\n";
+    } else {
+        out_ << "ll1,";
+        buildBool(!table_.hasConflict());
+        out_ << '\n';
+    }
+}
+
+void LL1Analyzer::RecordBuilder::buildField(std::string_view key, bool isFirst) {
+    if (isJson()) {
+        if (!isFirst) { out_ << ','; }
+        out_ << '"' << key << "\":";
+    } else {
+        out_ << ',';
+    }
+}
+
+void LL1Analyzer::RecordBuilder::buildName(std::string_view name) {
+    static constexpr char hex[] = "0123456789abcdef";
+    if (isJson()) {
+        out_ << '"';
+        for (auto c : name) {
+            if (c == '"' || c == '\\') {
+                out_ << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out_ << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+            } else {
+                out_ << c;
+            }
+        }
+        out_ << '"';
+        return;
+    }
+
+    // A csv field is quoted only if it must be, and its quotes are doubled.
+    if (name.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out_ << name;
+        return;
+    }
+    out_ << '"';
+    for (auto c : name) {
+        if (c == '"') { out_ << '"'; }
+        out_ << c;
+    }
+    out_ << '"';
+}
+
+void LL1Analyzer::RecordBuilder::buildBool(bool value) {
+    if (isJson()) {
+        out_ << (value ? "true" : "false");
+    } else {
+        out_ << (value ? '1' : '0');
+    }
+}
+
+template <typename Ids>
+void LL1Analyzer::RecordBuilder::buildIds(const Ids &ids) {
+    if (isJson()) { out_ << '['; }
+    bool isFirst = true;
+    for (auto id : ids) {
+        if (!isFirst) { out_ << (isJson() ? ',' : ' '); }
+        isFirst = false;
+        out_ << idOf(id);
+    }
+    if (isJson()) { out_ << ']'; }
+}
@@ -0,0 +1,171 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LR0Analyzer.h"
+#include "ConcurrentHashMap.h"
+#include "WorkStealingPool.h"
+
+using namespace csa;
+
+int LR0Analyzer::parse() {
+    if (gc_ == nullptr || gc_->pl->table().empty()) { return 1; }
+    if (isParsed_) { return 0; }
+
+    sf_ = buildStateFamily(gc_, jobs_);
+    buildLRxTable(*sf_, lrxTable_);
+    isParsed_ = true;
+
+    return 0;
+}
+
+LRxStateFamilyPtr LR0Analyzer::buildStateFamily(GrammarContextPtr gc, std::size_t jobs) {
+    if (jobs > 1) { return buildStateFamilyInParallel(gc, jobs); }
+
+    auto sf = std::make_shared<LRxStateFamily>(gc);
+    LRxStateFamily::Workspace ws;
+
+    sf->createNewState({sf->itemId(gc->pl->table().front())});
+    for (std::size_t id = 0; id < sf->stateCount(); ++id) { sf->expand(*sf->getState(id), ws); }
+
+    return sf;
+}
+
+LRxStateFamilyPtr LR0Analyzer::buildStateFamilyInParallel(GrammarContextPtr gc, std::size_t jobs) {
+    using ItemList = LRxStateFamily::ItemList;
+    constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // A state found by a worker, it is numbered after all the states are found.
+    struct Node {
+        ItemList kernel;
+        std::size_t id = npos;
+        std::vector<std::pair<SymbolId, Node *>> transitions;
+        std::vector<int> reductions;
+    };
+    struct KernelHash {
+        std::size_t operator()(const ItemList &kernel) const { return LRxStateFamily::hashOf(kernel); }
+    };
+
+    // The item table is read only while workers expand states.
+    auto sf = std::make_shared<LRxStateFamily>(gc);
+    WorkStealingPool<Node *> pool(jobs);
+    ConcurrentHashMap<ItemList, Node *, KernelHash> nodeOfKernel(jobs * 64);
+    std::vector<std::deque<Node>> nodes(jobs);    ///< Worker index mapping the nodes it creates.
+    std::vector<LRxStateFamily::Workspace> workspaces(jobs);
+
+    auto findOrCreate = [&](const ItemList &kernel, std::size_t worker) {
+        auto [node, isCreated] = nodeOfKernel.findOrInsert(kernel, LRxStateFamily::hashOf(kernel), [&] {
+            auto &theNode = nodes[worker].emplace_back();
+            theNode.kernel = kernel;
+            return &theNode;
+        });
+        if (isCreated) { pool.push(worker, node); }
+        return node;
+    };
+
+    auto root = findOrCreate({sf->itemId(gc->pl->table().front())}, 0);
+    pool.run([&](Node *node, std::size_t worker) {
+        auto &ws = workspaces[worker];
+        sf->closure(node->kernel, ws.items, ws);
+        for (auto id : ws.items) {
+            auto &item = sf->getItem(id);
+            if (item.isComplete()) { node->reductions.push_back(item.p->id); }
+        }
+        std::sort(node->reductions.begin(), node->reductions.end());
+
+        sf->gotoKernels(ws.items, ws);
+        for (auto symbol : ws.symbols) { node->transitions.push_back({symbol, findOrCreate(ws.kernels[symbol], worker)}); }
+    });
+
+    // Number the states in the serial order: breadth first, and the goto states in the order of symbol id.
+    std::vector<Node *> order{root};
+    root->id = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (auto &[symbol, target] : order[i]->transitions) {
+            if (target->id == npos) {
+                target->id = order.size();
+                order.push_back(target);
+            }
+        }
+    }
+
+    for (auto node : order) { sf->createNewState(std::move(node->kernel)); }
+    for (auto node : order) {
+        auto state = sf->getState(node->id);
+        for (auto &[symbol, target] : node->transitions) { state->transitions.push_back({symbol, sf->getState(target->id)}); }
+        state->reductions = std::move(node->reductions);
+    }
+
+    return sf;
+}
+
+void LR0Analyzer::buildLRxTable(const LRxStateFamily &sf, LRxTable &table, const Lookaheads *lookaheads) {
+    using Action = LRxTable::Action;
+
+    auto gc = sf.grammarContext();
+
+    // Columns are the terminals in the order of symbol id, then the nonterminals.
+    SymbolList terminals;
+    SymbolList nonterminals;
+    for (auto symbol : gc->st->table()) {
+        if (symbol->isAlienSymbol() || symbol->isTerminalEpsilon() || symbol->isStartSymbol()) { continue; }
+        (symbol->isTerminal() ? terminals : nonterminals).push_back(symbol);
+    }
+    auto columns = terminals;
+    columns.insert(columns.end(), nonterminals.begin(), nonterminals.end());
+    table.reset(sf.stateCount(), columns, terminals.size(), gc->st->symbolCount());
+
+    // The start production ends with eof, accept instead of shifting it.
+    auto &startProduction = gc->pl->table().front();
+    auto acceptItem = sf.itemId(startProduction, startProduction.rhs.symbolList.size() - 1);
+    auto eof = startProduction.rhs.symbolList.back();
+
+    // Actions of a row are sorted by column before they are added, so the conflicts stay in cell order.
+    std::vector<std::pair<std::size_t, Action>> row;
+    for (auto state : sf.stateTable()) {
+        row.clear();
+        auto &kernel = state->kernel;
+        bool isAcceptState = std::binary_search(kernel.begin(), kernel.end(), acceptItem);
+
+        for (auto &[symbol, target] : state->transitions) {
+            if (isAcceptState && symbol == eof->id()) { continue; }
+            row.push_back({table.columnOfSymbol[symbol], Action::makeGoto(target->id)});
+        }
+
+        if (isAcceptState) { row.push_back({table.columnOfSymbol[eof->id()], Action::makeAccept()}); }
+
+        auto &reductions = state->reductions;
+        for (std::size_t i = 0; i < reductions.size(); ++i) {
+            auto action = Action::makeReduce(reductions[i]);
+            if (lookaheads) {
+                for (auto id : (*lookaheads)[state->id][i]) { row.push_back({table.columnOfSymbol[id], action}); }
+            } else {
+                for (std::size_t column = 0; column < terminals.size(); ++column) { row.push_back({column, action}); }
+            }
+        }
+
+        std::sort(row.begin(), row.end());
+        for (auto &[column, action] : row) { table.add(state->id, column, action); }
+    }
+}
+
+bool LR0Analyzer::isValidLR0() {
+    if (!isParsed_) { return false; }
+
+    bool good = true;
+    if (lrxTable_.hasConflict()) {
+        auto cell = lrxTable_.conflicts.front().cell;
+        printf("[LR0Analyzer::isValidLR0]\n");
+        printf("  [note] state(id=%zu) has conflict actions on symbol [%s], ", lrxTable_.rowOf(cell),
+               lrxTable_.symbolOf(cell)->name().data());
+        printf("it's invalid LR0 grammar.\n");
+        good = false;
+    }
+
+    return good;
+}
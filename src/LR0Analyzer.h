@@ -0,0 +1,72 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+
+namespace csa {
+
+/**
+ * @brief Build the LR(0) canonical collection and the LR(0) table of a grammar.
+ */
+class LR0Analyzer {
+public:
+    /**
+     * @brief State id mapping the lookahead sets of its reductions, in the order of State::reductions.
+     */
+    using Lookaheads = std::vector<std::vector<SymbolSet>>;
+
+    LR0Analyzer(GrammarContextPtr gc) : gc_(gc), isParsed_(false) {}
+    void setJobs(std::size_t jobs) { jobs_ = jobs; }
+    int parse();
+    bool isValidLR0();
+
+    /**
+     * @brief Get the LR(0) states, they are built by parse().
+     */
+    LRxStateFamilyPtr stateFamily() const { return sf_; }
+
+    /**
+     * @brief Get the LR(0) table, it is built by parse().
+     */
+    const LRxTable &lrxTable() const { return lrxTable_; }
+
+    /**
+     * @brief Build the LR(0) states of a grammar.
+     *
+     * States are expanded in the order they are created, so the state ids are deterministic.
+     * With more than one job, states are expanded by a work-stealing pool and renumbered at the end,
+     * the result is the same as the serial build.
+     *
+     * @param[in] gc    Grammar context.
+     * @param[in] jobs  Count of the threads.
+     */
+    static LRxStateFamilyPtr buildStateFamily(GrammarContextPtr gc, std::size_t jobs = 1);
+
+    /**
+     * @brief Fill a LRx table with the goto, accept and reduce actions of some states.
+     *
+     * @param[in] sf            Input states.
+     * @param[out] table        Output table.
+     * @param[in] lookaheads    Lookaheads of the reductions, nullptr means reducing on all the terminals.
+     */
+    static void buildLRxTable(const LRxStateFamily &sf, LRxTable &table, const Lookaheads *lookaheads = nullptr);
+
+private:
+    static LRxStateFamilyPtr buildStateFamilyInParallel(GrammarContextPtr gc, std::size_t jobs);
+
+    GrammarContextPtr gc_;
+    bool isParsed_;
+    std::size_t jobs_ = 1;
+    LRxStateFamilyPtr sf_;
+    LRxTable lrxTable_;
+};
+
+}    // namespace csa
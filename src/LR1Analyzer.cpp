@@ -0,0 +1,239 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "LR1Analyzer.h"
+#include "LL1Analyzer.h"
+
+using namespace csa;
+
+int LR1Analyzer::parse() {
+    if (gc_ == nullptr || gc_->pl->table().empty()) { return 1; }
+    if (isParsed_) { return 0; }
+
+    // First sets of the suffixes.
+    LL1Analyzer theLL1Analyzer(gc_);
+    if (theLL1Analyzer.parse() != 0) { return 1; }
+
+    sf_ = std::make_shared<LRxStateFamily>(gc_);
+    buildStates();
+    buildStateFamily();
+    LR0Analyzer::buildLRxTable(*sf_, lrxTable_, &lookaheads_);
+    isParsed_ = true;
+
+    return 0;
+}
+
+void LR1Analyzer::buildStates() {
+    statistics_ = {};
+    states_.clear();
+    statesOfKernel_.clear();
+    queue_.clear();
+
+    auto symbolCount = gc_->st->symbolCount();
+    productionsOf_.assign(symbolCount, {});
+    for (auto &p : gc_->pl->table()) { productionsOf_[p.lhs.symbol->id()].push_back(&p); }
+    lookaheadsOf_.assign(symbolCount, {});
+    isClosed_.assign(symbolCount, false);
+    closed_.clear();
+
+    // The start item looks ahead nothing, it never reduces before accept.
+    LRxStateFamily::ItemList kernel{sf_->itemId(gc_->pl->table().front())};
+    std::vector<SymbolSet> lookaheads(1);
+    findOrMerge(kernel, lookaheads);
+
+    while (!queue_.empty()) {
+        auto id = queue_.front();
+        queue_.pop_front();
+        states_[id].isQueued = false;
+        expand(id);
+    }
+    statistics_.builtStateCount = states_.size();
+}
+
+void LR1Analyzer::expand(std::size_t id) {
+    ++statistics_.expandCount;
+
+    // States may grow while expanding, so the kernel is copied.
+    auto kernel = states_[id].kernel;
+    auto kernelLookaheads = states_[id].lookaheads;
+
+    // Lookaheads of the closure items of every nonterminal, they are solved by a worklist.
+    for (auto symbol : closed_) {
+        lookaheadsOf_[symbol->id()].clear();
+        isClosed_[symbol->id()] = false;
+    }
+    closed_.clear();
+    auto addLookaheads = [&](SymbolPtr symbol, const Production::RightHandSide::Suffix &suffix,
+                             const SymbolSet &lookaheads) {
+        auto &set = lookaheadsOf_[symbol->id()];
+        bool changed = set.unite(suffix.firstSet);
+        if (suffix.isNillable) { changed = set.unite(lookaheads) || changed; }
+        if (!isClosed_[symbol->id()]) {
+            isClosed_[symbol->id()] = true;
+            closed_.push_back(symbol);
+            changed = true;
+        }
+        if (changed) { worklist_.push_back(symbol); }
+    };
+
+    for (std::size_t i = 0; i < kernel.size(); ++i) {
+        auto &item = sf_->getItem(kernel[i]);
+        if (item.next != nullptr && item.next->isNonterminal()) {
+            addLookaheads(item.next, item.p->rhs.suffixList[item.dot + 1], kernelLookaheads[i]);
+        }
+    }
+    while (!worklist_.empty()) {
+        auto symbol = worklist_.back();
+        worklist_.pop_back();
+        for (auto p : productionsOf_[symbol->id()]) {
+            auto &item = sf_->getItem(sf_->itemId(*p));
+            if (item.next != nullptr && item.next->isNonterminal()) {
+                addLookaheads(item.next, p->rhs.suffixList[1], lookaheadsOf_[symbol->id()]);
+            }
+        }
+    }
+
+    // Collect the goto kernels and the reductions.
+    std::map<SymbolId, std::vector<std::pair<LRxStateFamily::ItemId, const SymbolSet *>>> gotoItems;
+    std::map<int, SymbolSet> reductions;
+    auto collect = [&](LRxStateFamily::ItemId itemId, const SymbolSet &lookaheads) {
+        auto &item = sf_->getItem(itemId);
+        if (item.isComplete()) {
+            reductions[item.p->id].unite(lookaheads);
+        } else {
+            gotoItems[item.next->id()].push_back({itemId + 1, &lookaheads});
+        }
+    };
+    for (std::size_t i = 0; i < kernel.size(); ++i) { collect(kernel[i], kernelLookaheads[i]); }
+    for (auto symbol : closed_) {
+        for (auto p : productionsOf_[symbol->id()]) { collect(sf_->itemId(*p), lookaheadsOf_[symbol->id()]); }
+    }
+
+    std::vector<int> reductionIds;
+    std::vector<SymbolSet> reductionLookaheads;
+    for (auto &[pid, lookaheads] : reductions) {
+        reductionIds.push_back(pid);
+        reductionLookaheads.push_back(std::move(lookaheads));
+    }
+
+    std::vector<std::pair<SymbolId, std::size_t>> transitions;
+    for (auto &[symbol, items] : gotoItems) {
+        std::sort(items.begin(), items.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        LRxStateFamily::ItemList gotoKernel;
+        std::vector<SymbolSet> gotoLookaheads;
+        for (auto &[itemId, set] : items) {
+            if (gotoKernel.empty() || gotoKernel.back() != itemId) {
+                gotoKernel.push_back(itemId);
+                gotoLookaheads.emplace_back();
+            }
+            gotoLookaheads.back().unite(*set);
+        }
+        transitions.push_back({symbol, findOrMerge(gotoKernel, gotoLookaheads)});
+    }
+
+    auto &state = states_[id];
+    state.transitions = std::move(transitions);
+    state.reductions = std::move(reductionIds);
+    state.reductionLookaheads = std::move(reductionLookaheads);
+}
+
+std::size_t LR1Analyzer::findOrMerge(LRxStateFamily::ItemList &kernel, std::vector<SymbolSet> &lookaheads) {
+    auto &group = statesOfKernel_[kernel];
+
+    for (auto id : group) {
+        auto &state = states_[id];
+        if (!isCompatible(state.lookaheads, lookaheads)) { continue; }
+
+        // Grow the state, and expand it again to pass the lookaheads to its successors.
+        bool changed = false;
+        for (std::size_t i = 0; i < lookaheads.size(); ++i) { changed = state.lookaheads[i].unite(lookaheads[i]) || changed; }
+        if (changed) {
+            ++statistics_.mergeCount;
+            if (!state.isQueued) {
+                state.isQueued = true;
+                queue_.push_back(id);
+            }
+        }
+        return id;
+    }
+
+    auto id = states_.size();
+    auto &state = states_.emplace_back();
+    state.kernel = kernel;
+    state.lookaheads = std::move(lookaheads);
+    state.isQueued = true;
+    queue_.push_back(id);
+    group.push_back(id);
+    return id;
+}
+
+bool LR1Analyzer::isCompatible(const std::vector<SymbolSet> &a, const std::vector<SymbolSet> &b) const {
+    if (merging_ == Merging::canonical) { return a == b; }
+
+    // Pager's weak compatibility: merging never makes a new conflict between two kernel items,
+    // unless the conflict is already in one of the states.
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        for (std::size_t j = i + 1; j < a.size(); ++j) {
+            if (!a[i].intersects(b[j]) && !b[i].intersects(a[j])) { continue; }
+            if (a[i].intersects(a[j]) || b[i].intersects(b[j])) { continue; }
+            return false;
+        }
+    }
+    return true;
+}
+
+void LR1Analyzer::buildStateFamily() {
+    // A merged state may drop some transitions to older states, so only the reachable
+    // states are kept, and they are numbered in breadth first order.
+    constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> newId(states_.size(), npos);
+    std::vector<std::size_t> order{0};
+    newId[0] = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (auto &[symbol, target] : states_[order[i]].transitions) {
+            if (newId[target] == npos) {
+                newId[target] = order.size();
+                order.push_back(target);
+            }
+        }
+    }
+
+    for (auto id : order) { sf_->createSharedState(states_[id].kernel); }
+
+    lookaheads_.assign(order.size(), {});
+    for (auto id : order) {
+        auto &state = states_[id];
+        auto theState = sf_->getState(newId[id]);
+        for (auto &[symbol, target] : state.transitions) {
+            theState->transitions.push_back({symbol, sf_->getState(newId[target])});
+        }
+        theState->reductions = state.reductions;
+        lookaheads_[newId[id]] = state.reductionLookaheads;
+    }
+
+    states_.clear();
+    statesOfKernel_.clear();
+    lookaheadsOf_.clear();
+}
+
+bool LR1Analyzer::isValidLR1() {
+    if (!isParsed_) { return false; }
+
+    bool good = true;
+    if (lrxTable_.hasConflict()) {
+        auto cell = lrxTable_.conflicts.front().cell;
+        printf("[LR1Analyzer::isValidLR1]\n");
+        printf("  [note] state(id=%zu) has conflict actions on symbol [%s], ", lrxTable_.rowOf(cell),
+               lrxTable_.symbolOf(cell)->name().data());
+        printf("it's invalid LR1 grammar.\n");
+        good = false;
+    }
+
+    return good;
+}
@@ -0,0 +1,106 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+#include "LR0Analyzer.h"
+
+#include <deque>
+#include <unordered_map>
+
+namespace csa {
+
+/**
+ * @brief Build the LR(1) states and the LR(1) table of a grammar.
+ *
+ * With Pager's merging, a new state is merged into a state with the same kernel when their
+ * lookaheads are weakly compatible, which never adds a conflict. So the state count stays
+ * near LALR(1), and the table keeps the power of canonical LR(1).
+ */
+class LR1Analyzer {
+public:
+    /**
+     * @brief How states with the same kernel are merged.
+     */
+    enum class Merging : int {
+        canonical = 0,    ///< Merge only if the lookaheads are equal, it is canonical LR(1).
+        pager             ///< Merge if the lookaheads are weakly compatible.
+    };
+
+    LR1Analyzer(GrammarContextPtr gc) : gc_(gc), isParsed_(false) {}
+    void setMerging(Merging merging) { merging_ = merging; }
+    int parse();
+    bool isValidLR1();
+
+    /**
+     * @brief Get the LR(1) states, they are built by parse().
+     */
+    LRxStateFamilyPtr stateFamily() const { return sf_; }
+
+    /**
+     * @brief Get the lookaheads of every state's reductions, they are built by parse().
+     */
+    const LR0Analyzer::Lookaheads &lookaheads() const { return lookaheads_; }
+
+    /**
+     * @brief Get the LR(1) table, it is built by parse().
+     */
+    const LRxTable &lrxTable() const { return lrxTable_; }
+
+    /**
+     * @brief Some counters of the construction.
+     */
+    struct Statistics {
+        std::size_t builtStateCount = 0;    ///< States built, including the ones unreachable after merging.
+        std::size_t mergeCount = 0;         ///< Merges which grow the lookaheads of a state.
+        std::size_t expandCount = 0;        ///< State expansions, a grown state is expanded again.
+    };
+    const Statistics &statistics() const { return statistics_; }
+
+private:
+    struct State {
+        LRxStateFamily::ItemList kernel;
+        std::vector<SymbolSet> lookaheads;                    ///< Lookaheads of the kernel items.
+        std::vector<std::pair<SymbolId, std::size_t>> transitions;
+        std::vector<int> reductions;
+        std::vector<SymbolSet> reductionLookaheads;
+        bool isQueued = false;
+    };
+
+    void buildStates();
+    void expand(std::size_t id);
+    std::size_t findOrMerge(LRxStateFamily::ItemList &kernel, std::vector<SymbolSet> &lookaheads);
+    bool isCompatible(const std::vector<SymbolSet> &a, const std::vector<SymbolSet> &b) const;
+    void buildStateFamily();
+
+    GrammarContextPtr gc_;
+    bool isParsed_;
+    Merging merging_ = Merging::pager;
+    LRxStateFamilyPtr sf_;
+    LR0Analyzer::Lookaheads lookaheads_;
+    LRxTable lrxTable_;
+    Statistics statistics_;
+
+    std::vector<State> states_;                                     ///< States being built.
+    struct KernelHash {
+        std::size_t operator()(const LRxStateFamily::ItemList &kernel) const { return LRxStateFamily::hashOf(kernel); }
+    };
+    std::unordered_map<LRxStateFamily::ItemList, std::vector<std::size_t>, KernelHash> statesOfKernel_;
+    std::deque<std::size_t> queue_;                                 ///< States to be expanded.
+
+    // Scratch memory of expand().
+    std::vector<std::vector<const Production *>> productionsOf_;    ///< Symbol id mapping its productions.
+    std::vector<SymbolSet> lookaheadsOf_;                           ///< Symbol id mapping its closure lookaheads.
+    std::vector<bool> isClosed_;
+    std::vector<SymbolPtr> closed_;
+    std::vector<SymbolPtr> worklist_;
+};
+
+}    // namespace csa
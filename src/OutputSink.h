@@ -0,0 +1,184 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace csa {
+
+/**
+ * @brief An output sink with a bounded buffer.
+ *
+ * Text is collected in a fixed size buffer and written out when the buffer is full,
+ * so the memory used by a writer never scales with the output size.
+ * A derived sink only decides where the buffer goes, and it must flush in its destructor.
+ */
+class OutputSink {
+public:
+    static constexpr std::size_t defaultCapacity = 64 * 1024;
+
+    OutputSink(std::size_t capacity = defaultCapacity) { buffer_.reserve(capacity ? capacity : 1); }
+    virtual ~OutputSink() = default;
+    OutputSink(const OutputSink &) = delete;
+    OutputSink &operator=(const OutputSink &) = delete;
+
+    OutputSink &write(std::string_view text) {
+        if (buffer_.size() + text.size() > buffer_.capacity()) {
+            flush();
+            // A piece bigger than the buffer is written out directly.
+            if (text.size() > buffer_.capacity()) {
+                if (good_) { good_ = writeOut(text.data(), text.size()); }
+                return *this;
+            }
+        }
+        buffer_.insert(buffer_.end(), text.begin(), text.end());
+        return *this;
+    }
+
+    OutputSink &put(char c) {
+        if (buffer_.size() == buffer_.capacity()) { flush(); }
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    OutputSink &operator<<(std::string_view text) { return write(text); }
+    OutputSink &operator<<(char c) { return put(c); }
+    OutputSink &operator<<(std::size_t value) {
+        char text[24];
+        auto end = std::to_chars(text, text + sizeof(text), value).ptr;
+        return write(std::string_view(text, static_cast<std::size_t>(end - text)));
+    }
+
+    /**
+     * @brief Write out the buffered text.
+     *
+     * @return true     All the text is written out.
+     * @return false    Some text failed to write out.
+     */
+    bool flush() {
+        if (!buffer_.empty()) {
+            if (good_) { good_ = writeOut(buffer_.data(), buffer_.size()); }
+            buffer_.clear();
+        }
+        return good_;
+    }
+
+    bool good() const { return good_; }
+
+protected:
+    /**
+     * @brief Write out some data to the destination.
+     *
+     * @return true     Write pass.
+     * @return false    Write error, and the sink drops all the text after it.
+     */
+    virtual bool writeOut(const char *data, std::size_t size) = 0;
+
+private:
+    std::vector<char> buffer_;    ///< The bounded buffer, its capacity never changes.
+    bool good_ = true;            ///< Is there no write error.
+};
+
+/**
+ * @brief Write to a string, it is used by the string returning APIs.
+ */
+class StringOutputSink : public OutputSink {
+public:
+    StringOutputSink(std::string &str, std::size_t capacity = defaultCapacity)
+        : OutputSink(capacity), str_(str) {}
+    ~StringOutputSink() override { flush(); }
+
+protected:
+    bool writeOut(const char *data, std::size_t size) override {
+        str_.append(data, size);
+        return true;
+    }
+
+private:
+    std::string &str_;
+};
+
+/**
+ * @brief Write to a std::ostream.
+ */
+class StreamOutputSink : public OutputSink {
+public:
+    StreamOutputSink(std::ostream &os, std::size_t capacity = defaultCapacity)
+        : OutputSink(capacity), os_(os) {}
+    ~StreamOutputSink() override { flush(); }
+
+protected:
+    bool writeOut(const char *data, std::size_t size) override {
+        os_.write(data, static_cast<std::streamsize>(size));
+        return static_cast<bool>(os_);
+    }
+
+private:
+    std::ostream &os_;
+};
+
+/**
+ * @brief Write to a FILE, the file is not closed by the sink.
+ */
+class FileOutputSink : public OutputSink {
+public:
+    FileOutputSink(FILE *file, std::size_t capacity = defaultCapacity)
+        : OutputSink(capacity), file_(file) {}
+    ~FileOutputSink() override { flush(); }
+
+protected:
+    bool writeOut(const char *data, std::size_t size) override {
+        return file_ && fwrite(data, 1, size, file_) == size;
+    }
+
+private:
+    FILE *file_;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Write to a file descriptor, the descriptor is not closed by the sink.
+ */
+class FdOutputSink : public OutputSink {
+public:
+    FdOutputSink(int fd, std::size_t capacity = defaultCapacity) : OutputSink(capacity), fd_(fd) {}
+    ~FdOutputSink() override { flush(); }
+
+protected:
+    bool writeOut(const char *data, std::size_t size) override {
+        while (size > 0) {
+            auto n = ::write(fd_, data, size);
+            if (n < 0) {
+                if (errno == EINTR) { continue; }
+                return false;
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+private:
+    int fd_;
+};
+#endif
+
+}    // namespace csa
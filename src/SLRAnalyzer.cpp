@@ -0,0 +1,80 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "SLRAnalyzer.h"
+
+using namespace csa;
+
+int SLRAnalyzer::parse() {
+    if (gc_ == nullptr || gc_->pl->table().empty()) { return 1; }
+    if (isParsed_) { return 0; }
+
+    LL1Analyzer theLL1Analyzer(gc_);
+    if (theLL1Analyzer.parse() != 0) { return 1; }
+
+    return parse(theLL1Analyzer);
+}
+
+int SLRAnalyzer::parse(const LL1Analyzer &theLL1Analyzer) {
+    if (gc_ == nullptr || gc_->pl->table().empty() || !theLL1Analyzer.isParsed()) { return 1; }
+    if (isParsed_) { return 0; }
+
+    sf_ = LR0Analyzer::buildStateFamily(gc_, jobs_);
+    buildLookaheads();
+    LR0Analyzer::buildLRxTable(*sf_, lrxTable_, &lookaheads_);
+    buildConflicts();
+    isParsed_ = true;
+
+    return 0;
+}
+
+void SLRAnalyzer::buildLookaheads() {
+    auto &pl = gc_->pl->table();
+
+    lookaheads_.assign(sf_->stateCount(), {});
+    for (auto state : sf_->stateTable()) {
+        auto &lookaheads = lookaheads_[state->id];
+        for (auto pid : state->reductions) { lookaheads.push_back(pl[pid].lhs.symbol->followSet()); }
+    }
+}
+
+void SLRAnalyzer::buildConflicts() {
+    using Action = LRxTable::Action;
+
+    // The conflicts of the table are in cell order, so they are in the order of state id then symbol id.
+    conflicts_.clear();
+    for (auto &conflict : lrxTable_.conflicts) {
+        Conflict theConflict{static_cast<int>(lrxTable_.rowOf(conflict.cell)), lrxTable_.symbolOf(conflict.cell), false, {}};
+        for (auto action : lrxTable_.actionsOf(conflict)) {
+            if (action.type() == Action::Type::Reduce) {
+                theConflict.reductions.push_back(action.reducePid());
+            } else {
+                theConflict.hasShift = true;
+            }
+        }
+        conflicts_.push_back(std::move(theConflict));
+    }
+}
+
+bool SLRAnalyzer::isValidSLR() {
+    if (!isParsed_) { return false; }
+
+    // Report the conflicting terminals of every state.
+    for (std::size_t i = 0; i < conflicts_.size();) {
+        auto state = conflicts_[i].state;
+        printf("[SLRAnalyzer::isValidSLR]\n");
+        printf("  [note] state(id=%d) has conflict actions on symbol", state);
+        for (; i < conflicts_.size() && conflicts_[i].state == state; ++i) {
+            printf(" [%s]", conflicts_[i].symbol->name().data());
+        }
+        printf(", it's invalid SLR grammar.\n");
+    }
+
+    return conflicts_.empty();
+}
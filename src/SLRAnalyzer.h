@@ -0,0 +1,89 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include "BaseType.h"
+#include "LL1Analyzer.h"
+#include "LR0Analyzer.h"
+
+namespace csa {
+
+/**
+ * @brief Build the SLR(1) table of a grammar from its LR(0) states.
+ *
+ * A state reduces A -> w on the follow set of A. It is the cheapest LR(1) check,
+ * a grammar without SLR(1) conflicts needs no LALR(1) lookaheads.
+ */
+class SLRAnalyzer {
+public:
+    SLRAnalyzer(GrammarContextPtr gc) : gc_(gc), isParsed_(false) {}
+    void setJobs(std::size_t jobs) { jobs_ = jobs; }
+
+    /**
+     * @brief Build the follow sets by a LL1Analyzer, then the states and the table.
+     */
+    int parse();
+
+    /**
+     * @brief Build the states and the table with the follow sets of a parsed LL1Analyzer.
+     *
+     * The follow sets are stored by the symbols of the grammar context, so they are not computed again.
+     *
+     * @return 0        Pass.
+     * @return other    The LL1Analyzer is not parsed.
+     */
+    int parse(const LL1Analyzer &theLL1Analyzer);
+
+    bool isValidSLR();
+
+    /**
+     * @brief Get the LR(0) states, they are built by parse().
+     */
+    LRxStateFamilyPtr stateFamily() const { return sf_; }
+
+    /**
+     * @brief Get the lookaheads of every state's reductions, they are built by parse().
+     */
+    const LR0Analyzer::Lookaheads &lookaheads() const { return lookaheads_; }
+
+    /**
+     * @brief Get the SLR(1) table, it is built by parse().
+     */
+    const LRxTable &lrxTable() const { return lrxTable_; }
+
+    /**
+     * @brief A terminal of a state which has more than one action.
+     */
+    struct Conflict {
+        int state;                      ///< State id.
+        SymbolPtr symbol;               ///< The lookahead terminal.
+        bool hasShift;                  ///< Is there a shift or accept besides the reductions.
+        std::vector<int> reductions;    ///< Production ids which reduce on the terminal.
+    };
+
+    /**
+     * @brief Get the conflicts in the order of state id then symbol id, they are built by parse().
+     */
+    const std::vector<Conflict> &conflicts() const { return conflicts_; }
+
+private:
+    void buildLookaheads();
+    void buildConflicts();
+
+    GrammarContextPtr gc_;
+    bool isParsed_;
+    std::size_t jobs_ = 1;
+    LRxStateFamilyPtr sf_;
+    LR0Analyzer::Lookaheads lookaheads_;
+    LRxTable lrxTable_;
+    std::vector<Conflict> conflicts_;
+};
+
+}    // namespace csa
@@ -0,0 +1,169 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace csa {
+
+/**
+ * @brief A pool of workers which run tasks until no task is left, tasks may push new tasks.
+ *
+ * Every worker owns a task queue. A worker takes its newest task first, and when its queue is
+ * empty it steals the oldest task of another worker, so a worker which finds much new work
+ * shares it without a central queue. A worker which finds no task to steal yields a few times,
+ * then sleeps until a task is pushed, so idle workers don't burn cores while the work is serial.
+ * The pool stops when all the pushed tasks are finished.
+ *
+ * @tparam Task     Task type, it should be cheap to copy.
+ */
+template <typename Task>
+class WorkStealingPool {
+public:
+    /**
+     * @brief Run a task on a worker, the worker index is in [0, workerCount()).
+     */
+    using Handler = std::function<void(Task task, std::size_t worker)>;
+
+    explicit WorkStealingPool(std::size_t workerCount) : queues_(workerCount ? workerCount : 1) {}
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    std::size_t workerCount() const { return queues_.size(); }
+
+    /**
+     * @brief Push a task to the queue of a worker.
+     *
+     * It is called by a handler with its own worker index, or before run().
+     */
+    void push(std::size_t worker, Task task) {
+        assert(worker < queues_.size());
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        {
+            auto &queue = queues_[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        // A worker counts itself sleeping before it checks the queues for the last time, so either
+        // it finds this task or it is woken up.
+        if (sleeping_.load() > 0) { wake(false); }
+    }
+
+    /**
+     * @brief Run all the tasks, it returns when no task is pending.
+     *
+     * The calling thread is worker 0, the other workers are new threads.
+     */
+    void run(const Handler &handler) {
+        std::vector<std::thread> threads;
+        for (std::size_t worker = 1; worker < queues_.size(); ++worker) {
+            threads.emplace_back([this, &handler, worker] { work(handler, worker); });
+        }
+        work(handler, 0);
+        for (auto &thread : threads) { thread.join(); }
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool pop(std::size_t worker, Task &task) {
+        auto &queue = queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) { return false; }
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(std::size_t worker, Task &task) {
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            auto &queue = queues_[(worker + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) { continue; }
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    bool hasTask() {
+        for (auto &queue : queues_) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) { return true; }
+        }
+        return false;
+    }
+
+    void wake(bool isAll) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++wakeCount_;
+        if (isAll) {
+            sleepCondition_.notify_all();
+        } else {
+            sleepCondition_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Sleep until a task is pushed or all the tasks are finished.
+     */
+    void sleep() {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        auto wakeCount = wakeCount_;
+        sleeping_.fetch_add(1);
+        lock.unlock();
+        if (!hasTask() && pending_.load() != 0) {
+            lock.lock();
+            sleepCondition_.wait(lock, [&] { return wakeCount_ != wakeCount; });
+        }
+        sleeping_.fetch_sub(1);
+    }
+
+    void work(const Handler &handler, std::size_t worker) {
+        static constexpr std::size_t yieldCount = 16;
+        Task task;
+        std::size_t idleCount = 0;
+        while (true) {
+            if (pop(worker, task) || steal(worker, task)) {
+                idleCount = 0;
+                handler(task, worker);
+                // New tasks of the handler are counted before this one finishes.
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) { wake(true); }
+            } else if (pending_.load(std::memory_order_acquire) == 0) {
+                break;
+            } else if (++idleCount < yieldCount) {
+                std::this_thread::yield();
+            } else {
+                sleep();
+            }
+        }
+    }
+
+    std::deque<Queue> queues_;                 ///< Worker index mapping its queue.
+    std::atomic<std::size_t> pending_{0};      ///< Tasks pushed but not finished.
+    std::atomic<std::size_t> sleeping_{0};     ///< Workers which are going to sleep or sleeping.
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+    std::size_t wakeCount_ = 0;                ///< It changes at every wake up, guarded by sleepMutex_.
+};
+
+}    // namespace csa
@@ -18,8 +18,53 @@ S -> ( S ) S
 S -> "epsilon"
 )";
 
+    // A caller-owned buffer ends with the two NUL bytes, it is scanned in place.
+    char buffer[] = "S -> ( S ) S\nS -> \"epsilon\"\n\0";
+    if(!GrammarContextBuilder::buildFromBuffer(buffer, sizeof(buffer))){
+        printf("test fail.\n");
+        return 1;
+    }
+
+    // An opened file is streamed chunk by chunk.
+    auto file = tmpfile();
+    if(file){
+        fputs("S -> ( S ) S\nS -> \"epsilon\"", file);
+        rewind(file);
+        auto gcFromFile = GrammarContextBuilder::buildFromFile(file);
+        fclose(file);
+        if(!gcFromFile){
+            printf("test fail.\n");
+            return 1;
+        }
+    }
+
+    // The last line of a streamed file is a comment without a newline, and the scanning
+    // starts where the file has been read to.
+    file = tmpfile();
+    if(file){
+        fputs("first line is read by the caller\nS -> ( S ) S\nS -> \"epsilon\"\n//S -> x", file);
+        rewind(file);
+        char line[64];
+        fgets(line, sizeof(line), file);
+        auto gcFromFile = GrammarContextBuilder::buildFromFile(file);
+        fclose(file);
+        auto gcFromStream = GrammarContextBuilder::buildFromStream("S -> ( S ) S\nS -> \"epsilon\"\n");
+        if(!gcFromFile || !gcFromStream || gcFromFile->pl->table().size() != gcFromStream->pl->table().size() ||
+           gcFromFile->st->symbolCount() != gcFromStream->st->symbolCount()){
+            printf("test fail.\n");
+            return 1;
+        }
+    }
+
     auto gc = GrammarContextBuilder::buildFromStream(stream);
 
+    // Every production table measures its own names, nothing is shared between grammars.
+    auto gcWithLongName = GrammarContextBuilder::buildFromStream("LongName -> x\n");
+    if(!gc || !gcWithLongName || gc->pl->getMaxWidthOfNt() != 5 || gcWithLongName->pl->getMaxWidthOfNt() != 8){
+        printf("test fail.\n");
+        return 1;
+    }
+
     if(gc){
         gc->pl->dump();
         gc->st->dump();
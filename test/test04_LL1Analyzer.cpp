@@ -13,22 +13,132 @@
 
 using namespace csa;
 
+// Build first and follow sets with the input engine and jobs, and convert them to strings for comparing.
+std::vector<std::string> setsOf(const std::string &stream, LL1Analyzer::FollowSetEngine engine, std::size_t jobs = 1) {
+    std::vector<std::string> result;
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (gc) {
+        LL1Analyzer theLL1Analyzer(gc);
+        theLL1Analyzer.setFollowSetEngine(engine);
+        theLL1Analyzer.setJobs(jobs);
+        if (theLL1Analyzer.parse() == 0) {
+            for (auto &p : gc->pl->table()) {
+                std::string str(p.lhs.symbol->name());
+                str += " :";
+                for (auto id : p.lhs.symbol->followSet()) {
+                    str += " ";
+                    str += gc->st->getSymbol(id)->name();
+                }
+                str += " | first :";
+                for (auto id : p.lhs.symbol->firstSet()) {
+                    str += " ";
+                    str += gc->st->getSymbol(id)->name();
+                }
+                result.push_back(str);
+            }
+        }
+    }
+    return result;
+}
+
 int main(){
     std::string stream = R"(
 S -> ( S ) S
 S -> "epsilon"
 )";
 
+    std::string stream2 = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E ) id
+)";
+
+    auto fixpoint = setsOf(stream2, LL1Analyzer::FollowSetEngine::fixpoint);
+    auto digraph = setsOf(stream2, LL1Analyzer::FollowSetEngine::digraph);
+    if (fixpoint.empty() || fixpoint != digraph) {
+        printf("--test LL1Analyzer follow set engines mismatch--\n");
+        return 1;
+    }
+
+    // The parallel analysis gives the same sets as the serial one.
+    if (setsOf(stream2, LL1Analyzer::FollowSetEngine::digraph, 4) != digraph) {
+        printf("--test LL1Analyzer parallel analysis mismatch--\n");
+        return 1;
+    }
+
     auto gc = GrammarContextBuilder::buildFromStream(stream);
     if(gc){
         LL1Analyzer theLL1Analyzer(gc);
         
         if(theLL1Analyzer.parse() == 0){
+            auto &table = theLL1Analyzer.ll1Table();
+            auto S = gc->st->findSymbol("S");
+            if (table.hasConflict() || table.rowCount() != 2 || table.columnCount() != 3 ||
+                table.find(S, gc->st->findSymbol("(")) != 1 ||
+                table.find(S, gc->st->findSymbol(")")) != 2) {
+                printf("--test LL1Analyzer LL(1) table failed--\n");
+                return 1;
+            }
+
+            auto &compressed = theLL1Analyzer.compressedLL1Table();
+            for (std::size_t row = 0; row < table.rowCount(); ++row) {
+                for (std::size_t column = 0; column < table.columnCount(); ++column) {
+                    if (compressed.at(row, column) != table.at(row, column)) {
+                        printf("--test LL1Analyzer compressed LL(1) table failed--\n");
+                        return 1;
+                    }
+                }
+            }
+            compressed.dump();
+
+            std::string parserCode;
+            {
+                StringOutputSink out(parserCode);
+                if (theLL1Analyzer.buildCppParser(out, "1Parser") == 0 ||
+                    theLL1Analyzer.buildCppParser(out, "ParenParser") != 0) {
+                    printf("--test LL1Analyzer cpp parser failed--\n");
+                    return 1;
+                }
+            }
+            if (parserCode.find("class ParenParser {") == std::string::npos ||
+                parserCode.find("bool parse1()") == std::string::npos) {
+                printf("--test LL1Analyzer cpp parser failed--\n");
+                return 1;
+            }
+
+            // Records list only the non-empty cells, in row major order.
+            std::string json, csv;
+            {
+                StringOutputSink jsonOut(json), csvOut(csv);
+                if (theLL1Analyzer.buildRecords(jsonOut, LL1Analyzer::RecordFormat::json) != 0 ||
+                    theLL1Analyzer.buildRecords(csvOut, LL1Analyzer::RecordFormat::csv) != 0) {
+                    printf("--test LL1Analyzer records failed--\n");
+                    return 1;
+                }
+            }
+            if (json.find("{\"id\":2,\"name\":\"(\",\"type\":\"terminal\",\"nillable\":false,\"first\":[2],\"follow\":[]}") ==
+                    std::string::npos ||
+                json.find("\"table\":{\"rows\":[5,1],\"columns\":[3,2,6],\"cells\":[\n[5,2,0],\n[5,6,0],\n"
+                          "[1,3,2],\n[1,2,1],\n[1,6,2]\n]},\n\"ll1\":true}\n") == std::string::npos ||
+                csv.find("production,2,1,4,1,,3 6\n") == std::string::npos ||
+                csv.find("cell,5,2,0\ncell,5,6,0\ncell,1,3,2\ncell,1,2,1\ncell,1,6,2\nll1,1\n") == std::string::npos) {
+                printf("--test LL1Analyzer records failed--\n");
+                return 1;
+            }
+
             std::cout << theLL1Analyzer.buildHtmlTable() << std::endl;
+            auto &statistics = theLL1Analyzer.statistics();
+            printf("nullable visits = %zu\n", statistics.nullableVisitCount);
+            printf("first set visits = %zu\n", statistics.firstSetVisitCount);
+            printf("follow set visits = %zu\n", statistics.followSetVisitCount);
             return 0;
         }
     }
 
     printf("--test LL1Analyzer failed--\n");
     return 1;
-}
\ No newline at end of file
+}
@@ -0,0 +1,103 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LR0Analyzer.h"
+#include <iostream>
+
+using namespace csa;
+
+int main(){
+    std::string stream = R"(
+S -> ( L )
+S -> x
+L -> S
+L -> L , S
+)";
+
+    std::string stream2 = R"(
+S -> ( S ) S
+S -> "epsilon"
+)";
+
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if(gc){
+        LR0Analyzer theLR0Analyzer(gc);
+
+        if(theLR0Analyzer.parse() == 0 && theLR0Analyzer.isValidLR0()){
+            auto sf = theLR0Analyzer.stateFamily();
+            sf->dumpStateTable();
+
+            // Start -> S $ adds the accept state and the state after eof to the 9 states of S.
+            if (sf->stateCount() != 10) {
+                printf("--test LR0Analyzer state count failed--\n");
+                return 1;
+            }
+
+            // Goto states are found by kernel.
+            auto &pl = gc->pl->table();
+            auto state0 = sf->getState(0);
+            auto x = gc->st->findSymbol("x");
+            auto target = sf->findState({sf->itemId(pl[2], 1)});    // S -> x .
+            if (target == nullptr || state0->gotoState(x->id()) != target ||
+                sf->findState({sf->itemId(pl[2], 0)}) != nullptr) {
+                printf("--test LR0Analyzer goto state failed--\n");
+                return 1;
+            }
+
+            auto &table = theLR0Analyzer.lrxTable();
+            auto accept = state0->gotoState(gc->st->findSymbol("S")->id());
+            auto action = table.find(accept->id, gc->st->findSymbol("$"));
+            if (action.type() != LRxTable::Action::Type::Accept) {
+                printf("--test LR0Analyzer accept action failed--\n");
+                return 1;
+            }
+
+            auto reduce = table.find(target->id, gc->st->findSymbol(")"));
+            if (reduce.toString() != "R2") {
+                printf("--test LR0Analyzer reduce action failed--\n");
+                return 1;
+            }
+
+            // The parallel build numbers the states the same as the serial build.
+            auto parallel = LR0Analyzer::buildStateFamily(gc, 4);
+            if (parallel->stateCount() != sf->stateCount()) {
+                printf("--test LR0Analyzer parallel build failed--\n");
+                return 1;
+            }
+            for (auto state : sf->stateTable()) {
+                auto other = parallel->getState(state->id);
+                bool isSame = other->kernel == state->kernel && other->reductions == state->reductions &&
+                              other->transitions.size() == state->transitions.size();
+                for (std::size_t i = 0; isSame && i < state->transitions.size(); ++i) {
+                    isSame = other->transitions[i].first == state->transitions[i].first &&
+                             other->transitions[i].second->id == state->transitions[i].second->id;
+                }
+                if (!isSame) {
+                    printf("--test LR0Analyzer parallel build failed--\n");
+                    return 1;
+                }
+            }
+
+            // S -> epsilon conflicts with shifting "(".
+            auto gc2 = GrammarContextBuilder::buildFromStream(stream2);
+            LR0Analyzer theLR0Analyzer2(gc2);
+            if (!gc2 || theLR0Analyzer2.parse() != 0 || theLR0Analyzer2.isValidLR0()) {
+                printf("--test LR0Analyzer conflict failed--\n");
+                return 1;
+            }
+
+            printf("--test LR0Analyzer pass--\n");
+            return 0;
+        }
+    }
+
+    printf("--test LR0Analyzer failed--\n");
+    return 1;
+}
@@ -0,0 +1,89 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1Analyzer.h"
+#include "LL1Engine.h"
+#include <iostream>
+#include <sstream>
+
+using namespace csa;
+
+// Convert a space separated string to terminal ids.
+std::vector<SymbolId> terminalsOf(GrammarContextPtr gc, const std::string &input) {
+    std::vector<SymbolId> terminals;
+    std::istringstream iss(input);
+    std::string name;
+    while (iss >> name) { terminals.push_back(gc->st->findSymbol(name)->id()); }
+    return terminals;
+}
+
+int main(){
+    std::string stream = R"(
+S -> ( S ) S
+S -> "epsilon"
+)";
+
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) {
+        printf("--test LL1Engine build grammar context fail--\n");
+        return 1;
+    }
+
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) {
+        printf("--test LL1Engine parse grammar fail--\n");
+        return 1;
+    }
+
+    LL1Engine engine(gc, theLL1Analyzer.ll1Table());
+
+    // Start -> S $ is production 0, S -> ( S ) S is 1, S -> epsilon is 2.
+    if (engine.parse(terminalsOf(gc, "( ( ) ) ( ) $")) != LL1Engine::Status::accepted
+        || engine.productions() != std::vector<int>{0, 1, 1, 2, 2, 1, 2, 2}) {
+        printf("--test LL1Engine accept fail--\n");
+        return 1;
+    }
+
+    if (engine.parse(terminalsOf(gc, "$")) != LL1Engine::Status::accepted
+        || engine.productions() != std::vector<int>{0, 2}) {
+        printf("--test LL1Engine accept empty input fail--\n");
+        return 1;
+    }
+
+    if (engine.parse(terminalsOf(gc, "( ) ) ( $")) != LL1Engine::Status::rejected
+        || engine.consumedCount() != 2) {
+        printf("--test LL1Engine reject fail--\n");
+        return 1;
+    }
+
+    // Input ends without eof.
+    if (engine.parse(terminalsOf(gc, "( )")) != LL1Engine::Status::running) {
+        printf("--test LL1Engine running fail--\n");
+        return 1;
+    }
+
+    // Push terminals one by one.
+    engine.reset();
+    for (auto id : terminalsOf(gc, "( ( ) ) $")) { engine.push(id); }
+    if (engine.status() != LL1Engine::Status::accepted || engine.consumedCount() != 5) {
+        printf("--test LL1Engine push fail--\n");
+        return 1;
+    }
+
+    // Terminal after accept, and unknown terminal.
+    if (engine.push(gc->st->findSymbol("(")->id()) != LL1Engine::Status::accepted
+        || engine.parse(terminalsOf(gc, "( x")) != LL1Engine::Status::rejected) {
+        printf("--test LL1Engine unknown terminal fail--\n");
+        return 1;
+    }
+
+    printf("--test LL1Engine pass--\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LALRAnalyzer.h"
+#include <iostream>
+
+using namespace csa;
+
+int main(){
+    // It is LALR(1), but not SLR(1).
+    std::string stream = R"(
+S -> L = R
+S -> R
+L -> * R
+L -> id
+R -> L
+)";
+
+    // It is LR(1), but not LALR(1).
+    std::string stream2 = R"(
+S -> a A d
+S -> b B d
+S -> a B e
+S -> b A e
+A -> c
+B -> c
+)";
+
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if(gc){
+        LALRAnalyzer theLALRAnalyzer(gc);
+
+        if(theLALRAnalyzer.parse() == 0 && theLALRAnalyzer.isValidLALR()){
+            auto sf = theLALRAnalyzer.stateFamily();
+
+            // R -> L . reduces on "$" only, SLR(1) also reduces on "=".
+            auto state = sf->getState(0)->gotoState(gc->st->findSymbol("L")->id());
+            if (state == nullptr || state->reductions != std::vector<int>{5}) {
+                printf("--test LALRAnalyzer state failed--\n");
+                return 1;
+            }
+            auto &lookaheads = theLALRAnalyzer.lookaheads()[state->id].front();
+            if (lookaheads.size() != 1 || !lookaheads.contains(gc->st->findSymbol("$")->id())) {
+                printf("--test LALRAnalyzer lookaheads failed--\n");
+                return 1;
+            }
+
+            auto &table = theLALRAnalyzer.lrxTable();
+            auto action = table.find(state->id, gc->st->findSymbol("="));
+            if (action.type() != LRxTable::Action::Type::Goto ||
+                !table.find(state->id, gc->st->findSymbol("id")).isError()) {
+                printf("--test LALRAnalyzer table failed--\n");
+                return 1;
+            }
+
+            auto gc2 = GrammarContextBuilder::buildFromStream(stream2);
+            LALRAnalyzer theLALRAnalyzer2(gc2);
+            if (!gc2 || theLALRAnalyzer2.parse() != 0 || theLALRAnalyzer2.isValidLALR()) {
+                printf("--test LALRAnalyzer conflict failed--\n");
+                return 1;
+            }
+
+            auto &statistics = theLALRAnalyzer.statistics();
+            printf("nonterminal transitions = %zu\n", statistics.nonterminalTransitionCount);
+            printf("reads = %zu, includes = %zu, lookback = %zu\n", statistics.readsCount,
+                   statistics.includesCount, statistics.lookbackCount);
+            printf("--test LALRAnalyzer pass--\n");
+            return 0;
+        }
+    }
+
+    printf("--test LALRAnalyzer failed--\n");
+    return 1;
+}
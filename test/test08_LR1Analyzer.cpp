@@ -0,0 +1,84 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LALRAnalyzer.h"
+#include "LR1Analyzer.h"
+#include <iostream>
+
+using namespace csa;
+
+int main(){
+    // It is LALR(1), but not SLR(1).
+    std::string stream = R"(
+S -> L = R
+S -> R
+L -> * R
+L -> id
+R -> L
+)";
+
+    // It is LR(1), but not LALR(1).
+    std::string stream2 = R"(
+S -> a A d
+S -> b B d
+S -> a B e
+S -> b A e
+A -> c
+B -> c
+)";
+
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    auto gc2 = GrammarContextBuilder::buildFromStream(stream);
+    auto gc3 = GrammarContextBuilder::buildFromStream(stream);
+    if(gc && gc2 && gc3){
+        LR1Analyzer canonical(gc);
+        canonical.setMerging(LR1Analyzer::Merging::canonical);
+        LR1Analyzer pager(gc2);
+        LALRAnalyzer theLALRAnalyzer(gc3);
+
+        if(canonical.parse() == 0 && canonical.isValidLR1() && pager.parse() == 0 && pager.isValidLR1() &&
+           theLALRAnalyzer.parse() == 0){
+            // Pager's merging keeps the LALR(1) states of a LALR(1) grammar.
+            auto canonicalCount = canonical.stateFamily()->stateCount();
+            auto pagerCount = pager.stateFamily()->stateCount();
+            if (pagerCount != theLALRAnalyzer.stateFamily()->stateCount() || canonicalCount <= pagerCount) {
+                printf("--test LR1Analyzer state count failed--\n");
+                return 1;
+            }
+
+            // Only "$" follows L in the start state.
+            auto state = pager.stateFamily()->getState(0)->gotoState(gc2->st->findSymbol("L")->id());
+            if (state == nullptr || state->reductions != std::vector<int>{5} ||
+                pager.lookaheads()[state->id].front().size() != 1) {
+                printf("--test LR1Analyzer lookaheads failed--\n");
+                return 1;
+            }
+
+            // Pager's merging must not merge the two "c ." states.
+            auto gc4 = GrammarContextBuilder::buildFromStream(stream2);
+            auto gc5 = GrammarContextBuilder::buildFromStream(stream2);
+            LR1Analyzer canonical2(gc4);
+            canonical2.setMerging(LR1Analyzer::Merging::canonical);
+            LR1Analyzer pager2(gc5);
+            if (!gc4 || !gc5 || canonical2.parse() != 0 || !canonical2.isValidLR1() || pager2.parse() != 0 ||
+                !pager2.isValidLR1() || canonical2.stateFamily()->stateCount() != pager2.stateFamily()->stateCount()) {
+                printf("--test LR1Analyzer conflict failed--\n");
+                return 1;
+            }
+
+            printf("canonical states = %zu, pager states = %zu\n", canonicalCount, pagerCount);
+            printf("--test LR1Analyzer pass--\n");
+            return 0;
+        }
+    }
+
+    printf("--test LR1Analyzer failed--\n");
+    return 1;
+}
@@ -0,0 +1,81 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "SLRAnalyzer.h"
+#include <iostream>
+
+using namespace csa;
+
+int main(){
+    // It is SLR(1).
+    std::string stream = R"(
+E -> E + T
+E -> T
+T -> T * F
+T -> F
+F -> ( E )
+F -> id
+)";
+
+    // It is LALR(1), but not SLR(1).
+    std::string stream2 = R"(
+S -> L = R
+S -> R
+L -> * R
+L -> id
+R -> L
+)";
+
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if(gc){
+        // The follow sets of a parsed LL1Analyzer are reused.
+        LL1Analyzer theLL1Analyzer(gc);
+        SLRAnalyzer theSLRAnalyzer(gc);
+
+        if(theLL1Analyzer.parse() == 0 && theSLRAnalyzer.parse(theLL1Analyzer) == 0 && theSLRAnalyzer.isValidSLR()){
+            // T -> T . * F and E -> T . share a state, E -> T . reduces on the follow set of E.
+            auto state = theSLRAnalyzer.stateFamily()->getState(0)->gotoState(gc->st->findSymbol("T")->id());
+            if (state == nullptr || state->reductions != std::vector<int>{2} ||
+                theSLRAnalyzer.lookaheads()[state->id].front().size() != 3) {
+                printf("--test SLRAnalyzer lookaheads failed--\n");
+                return 1;
+            }
+
+            auto &table = theSLRAnalyzer.lrxTable();
+            if (table.find(state->id, gc->st->findSymbol(")")).reducePid() != 2 ||
+                !table.find(state->id, gc->st->findSymbol("id")).isError()) {
+                printf("--test SLRAnalyzer table failed--\n");
+                return 1;
+            }
+
+            // R -> L . reduces on "=", it conflicts with shifting "=".
+            auto gc2 = GrammarContextBuilder::buildFromStream(stream2);
+            SLRAnalyzer theSLRAnalyzer2(gc2);
+            if (!gc2 || theSLRAnalyzer2.parse() != 0 || theSLRAnalyzer2.isValidSLR() ||
+                theSLRAnalyzer2.conflicts().size() != 1) {
+                printf("--test SLRAnalyzer conflict failed--\n");
+                return 1;
+            }
+            auto &conflict = theSLRAnalyzer2.conflicts().front();
+            auto state2 = theSLRAnalyzer2.stateFamily()->getState(0)->gotoState(gc2->st->findSymbol("L")->id());
+            if (state2 == nullptr || conflict.state != state2->id || conflict.symbol != gc2->st->findSymbol("=") ||
+                !conflict.hasShift || conflict.reductions != std::vector<int>{5}) {
+                printf("--test SLRAnalyzer conflict failed--\n");
+                return 1;
+            }
+
+            printf("--test SLRAnalyzer pass--\n");
+            return 0;
+        }
+    }
+
+    printf("--test SLRAnalyzer failed--\n");
+    return 1;
+}
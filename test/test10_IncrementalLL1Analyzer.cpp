@@ -0,0 +1,250 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1Analyzer.h"
+#include <algorithm>
+
+using namespace csa;
+
+// Names of a set, they are sorted since the symbol ids of two grammar contexts may differ.
+std::string namesOf(GrammarContextPtr gc, const SymbolSet &set) {
+    std::vector<std::string> names;
+    for (auto id : set) { names.emplace_back(gc->st->getSymbol(id)->name()); }
+    std::sort(names.begin(), names.end());
+    std::string str;
+    for (auto &name : names) { str += " " + name; }
+    return str;
+}
+
+// Convert the analysis to strings for comparing: every production with its predict set,
+// every nonterminal with its sets, and every cell of the LL(1) table and the compressed table.
+std::vector<std::string> analysisOf(GrammarContextPtr gc, const LL1Analyzer &theLL1Analyzer) {
+    std::vector<std::string> result;
+    for (auto &p : gc->pl->table()) {
+        std::string str(p.lhs.symbol->name());
+        str += " ->";
+        for (auto &symbol : p.rhs.symbolList) { str += " " + std::string(symbol->name()); }
+        str += " | predict :" + namesOf(gc, p.rhs.predictSet);
+        result.push_back(str);
+    }
+
+    auto &table = theLL1Analyzer.ll1Table();
+    auto &compressed = theLL1Analyzer.compressedLL1Table();
+    for (std::size_t row = 0; row < table.rowCount(); ++row) {
+        auto symbol = table.nonterminals[row];
+        std::string str(symbol->name());
+        str += symbol->isNillable() ? " nillable" : "";
+        str += " | first :" + namesOf(gc, symbol->firstSet());
+        str += " | follow :" + namesOf(gc, symbol->followSet());
+        result.push_back(str);
+
+        for (std::size_t column = 0; column < table.columnCount(); ++column) {
+            if (compressed.at(row, column) != table.at(row, column)) { return {}; }
+            auto ids = table.productionsAt(row, column);
+            if (ids.empty()) { continue; }
+            str = std::string(symbol->name()) + " " + std::string(table.terminals[column]->name()) + " :";
+            for (auto id : ids) { str += " " + std::to_string(id); }
+            result.push_back(str);
+        }
+    }
+    return result;
+}
+
+// Analyze a grammar from the beginning.
+std::vector<std::string> analysisOf(const std::string &stream) {
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) { return {}; }
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) { return {}; }
+    return analysisOf(gc, theLL1Analyzer);
+}
+
+// Records of an analysis, they are written by symbol ids.
+std::string recordsOf(LL1Analyzer &theLL1Analyzer) {
+    std::string records;
+    StringOutputSink out(records);
+    if (theLL1Analyzer.buildRecords(out, LL1Analyzer::RecordFormat::json) != 0 || !out.flush()) { return {}; }
+    return records;
+}
+
+// Records of a grammar analyzed from the beginning.
+std::string recordsOf(const std::string &stream) {
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) { return {}; }
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) { return {}; }
+    return recordsOf(theLL1Analyzer);
+}
+
+int main() {
+    std::string stream = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E )
+)";
+
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) { return 1; }
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.addProduction("F", {"id"}) != -1 || theLL1Analyzer.parse() != 0) {
+        printf("--test IncrementalLL1Analyzer parse failed--\n");
+        return 1;
+    }
+
+    // Additions, with a new nillable nonterminal and a new terminal.
+    if (theLL1Analyzer.addProduction("A", {"epsilon"}) != 8 ||
+        theLL1Analyzer.addProduction("A", {"[", "E", "]"}) != 9 ||
+        theLL1Analyzer.addProduction("F", {"id", "A"}) != 10 ||
+        theLL1Analyzer.addProduction("T1", {"/", "F", "T1"}) != 11) {
+        printf("--test IncrementalLL1Analyzer add failed--\n");
+        return 1;
+    }
+    auto added = stream + R"(
+A   -> epsilon
+A   -> [ E ]
+F   -> id A
+T1  -> / F T1
+)";
+    if (analysisOf(gc, theLL1Analyzer).empty() || analysisOf(gc, theLL1Analyzer) != analysisOf(added)) {
+        printf("--test IncrementalLL1Analyzer add mismatch--\n");
+        return 1;
+    }
+
+    // Removals, A is not nillable any more, and "*" leaves the table.
+    if (theLL1Analyzer.removeProduction(8) != 0 || theLL1Analyzer.removeProduction(5) != 0) {
+        printf("--test IncrementalLL1Analyzer remove failed--\n");
+        return 1;
+    }
+    auto removed = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> epsilon
+F   -> ( E )
+A   -> [ E ]
+F   -> id A
+T1  -> / F T1
+)";
+    if (analysisOf(removed).empty() || analysisOf(gc, theLL1Analyzer) != analysisOf(removed)) {
+        printf("--test IncrementalLL1Analyzer remove mismatch--\n");
+        return 1;
+    }
+
+    // Invalid edits change nothing.
+    if (theLL1Analyzer.addProduction("A", {"[", "E", "]"}) != -1 ||
+        theLL1Analyzer.addProduction("id", {"E"}) != -1 ||
+        theLL1Analyzer.addProduction("A", {"epsilon", "E"}) != -1 ||
+        theLL1Analyzer.addProduction("A", {"$", "E"}) != -1 ||
+        theLL1Analyzer.removeProduction(0) == 0 ||
+        theLL1Analyzer.removeProduction(10) == 0 ||
+        analysisOf(gc, theLL1Analyzer) != analysisOf(removed)) {
+        printf("--test IncrementalLL1Analyzer invalid edit failed--\n");
+        return 1;
+    }
+
+    // Insertion at an id, the productions from it move, and the start production stays first.
+    if (theLL1Analyzer.addProduction("T1", {"*", "F", "T1"}, 0) != -1 ||
+        theLL1Analyzer.addProduction("T1", {"*", "F", "T1"}, 11) != -1 ||
+        theLL1Analyzer.addProduction("T1", {"*", "F", "T1"}, 5) != 5) {
+        printf("--test IncrementalLL1Analyzer insert failed--\n");
+        return 1;
+    }
+    auto inserted = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E )
+A   -> [ E ]
+F   -> id A
+T1  -> / F T1
+)";
+    if (analysisOf(gc, theLL1Analyzer) != analysisOf(inserted)) {
+        printf("--test IncrementalLL1Analyzer insert mismatch--\n");
+        return 1;
+    }
+
+    // The last production of A can't be removed while A is used, A would turn into a terminal,
+    // and it can be once A is not used.
+    if (theLL1Analyzer.removeProduction(8) == 0 || analysisOf(gc, theLL1Analyzer) != analysisOf(inserted) ||
+        theLL1Analyzer.removeProduction(9) != 0 || theLL1Analyzer.removeProduction(8) != 0) {
+        printf("--test IncrementalLL1Analyzer remove last production failed--\n");
+        return 1;
+    }
+    auto unused = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E )
+T1  -> / F T1
+)";
+    if (analysisOf(gc, theLL1Analyzer) != analysisOf(unused)) {
+        printf("--test IncrementalLL1Analyzer remove last production mismatch--\n");
+        return 1;
+    }
+
+    // The watch mode of the tool edits only while every symbol stays and keeps the id order of
+    // a fresh grammar context, then the records are the same as the records of a fresh analysis.
+    auto watched = GrammarContextBuilder::buildFromStream(stream);
+    if (!watched) { return 1; }
+    LL1Analyzer watchedLL1Analyzer(watched);
+    if (watchedLL1Analyzer.parse() != 0 || watchedLL1Analyzer.addProduction("F", {"(", "F", ")"}) != 8 ||
+        watchedLL1Analyzer.removeProduction(6) != 0) {
+        printf("--test IncrementalLL1Analyzer watched edit failed--\n");
+        return 1;
+    }
+    auto edited = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+F   -> ( E )
+F   -> ( F )
+)";
+    if (recordsOf(watchedLL1Analyzer).empty() || recordsOf(watchedLL1Analyzer) != recordsOf(edited)) {
+        printf("--test IncrementalLL1Analyzer watched records mismatch--\n");
+        return 1;
+    }
+
+    // A rule with one production is edited by adding the new production first, then removing the old one.
+    if (watchedLL1Analyzer.removeProduction(4) == 0 || watchedLL1Analyzer.addProduction("T", {"F", "T1", "+"}, 4) != 4 ||
+        watchedLL1Analyzer.removeProduction(5) != 0) {
+        printf("--test IncrementalLL1Analyzer watched single production edit failed--\n");
+        return 1;
+    }
+    auto singleEdited = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1 +
+T1  -> * F T1
+F   -> ( E )
+F   -> ( F )
+)";
+    if (recordsOf(watchedLL1Analyzer) != recordsOf(singleEdited) ||
+        analysisOf(watched, watchedLL1Analyzer) != analysisOf(singleEdited)) {
+        printf("--test IncrementalLL1Analyzer watched single production edit mismatch--\n");
+        return 1;
+    }
+
+    printf("incremental visits = %zu\n", theLL1Analyzer.statistics().incrementalVisitCount);
+    return 0;
+}
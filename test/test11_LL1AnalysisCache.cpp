@@ -0,0 +1,135 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "LL1AnalysisCache.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace csa;
+namespace fs = std::filesystem;
+
+// Analyze a grammar with a cache, and get its html table, empty if it fails.
+std::string htmlOf(LL1AnalysisCache &cache, const std::string &stream) {
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) { return {}; }
+    LL1Analyzer theLL1Analyzer(gc);
+    if (cache.parse(theLL1Analyzer) != 0) { return {}; }
+    return theLL1Analyzer.buildHtmlTable();
+}
+
+std::string htmlOf(const std::string &stream) {
+    auto gc = GrammarContextBuilder::buildFromStream(stream);
+    if (!gc) { return {}; }
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.parse() != 0) { return {}; }
+    return theLL1Analyzer.buildHtmlTable();
+}
+
+std::uintmax_t directorySizeOf(const fs::path &directory) {
+    std::uintmax_t size = 0;
+    for (auto &entry : fs::directory_iterator(directory)) { size += entry.file_size(); }
+    return size;
+}
+
+// Set the modified time of the entries which are newer than the time.
+void setTimeOfNewEntries(const fs::path &directory, fs::file_time_type newer, fs::file_time_type time) {
+    for (auto &entry : fs::directory_iterator(directory)) {
+        if (entry.last_write_time() > newer) { fs::last_write_time(entry.path(), time); }
+    }
+}
+
+bool isStatistics(const LL1AnalysisCache &cache, std::size_t hit, std::size_t miss, std::size_t store,
+                  std::size_t eviction) {
+    auto statistics = cache.statistics();
+    return statistics.hitCount == hit && statistics.missCount == miss && statistics.storeCount == store &&
+           statistics.evictionCount == eviction;
+}
+
+int main() {
+    std::string stream = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E )
+F   -> id
+)";
+    // The same productions in another layout.
+    std::string sameStream = "E -> T E1\nE1 -> + T E1\nE1 -> epsilon\nT -> F T1\nT1 -> * F T1\n\nT1 -> epsilon\nF\t-> (  E  )\nF -> id";
+    std::string otherStream = "S -> ( S ) S\nS -> epsilon\n";
+    std::string conflictStream = "S -> a S\nS -> a\n";
+
+    auto directory = fs::temp_directory_path() / "csa-test11-cache";
+    fs::remove_all(directory);
+
+    // A miss stores the results, then the same productions hit.
+    {
+        LL1AnalysisCache cache(directory.string());
+        auto html = htmlOf(stream);
+        if (html.empty() || htmlOf(cache, stream) != html || htmlOf(cache, sameStream) != html ||
+            htmlOf(cache, conflictStream) != htmlOf(conflictStream) || htmlOf(cache, conflictStream).empty() ||
+            !isStatistics(cache, 2, 2, 2, 0)) {
+            printf("--test LL1AnalysisCache hit failed--\n");
+            return 1;
+        }
+
+        // A broken entry is a miss, and it is stored again.
+        for (auto &entry : fs::directory_iterator(directory)) { fs::resize_file(entry.path(), entry.file_size() / 2); }
+        if (htmlOf(cache, stream) != html || htmlOf(cache, stream) != html || !isStatistics(cache, 3, 3, 3, 0)) {
+            printf("--test LL1AnalysisCache broken entry failed--\n");
+            return 1;
+        }
+    }
+
+    // The least recently used entry is evicted first.
+    fs::remove_all(directory);
+    std::vector<std::uintmax_t> sizes;
+    for (auto &text : {stream, otherStream, conflictStream}) {
+        LL1AnalysisCache cache(directory.string());
+        htmlOf(cache, text);
+        sizes.push_back(directorySizeOf(directory));
+        fs::remove_all(directory);
+    }
+    {
+        // The modified times are set explicitly, a file system may keep them in coarse units.
+        auto now = fs::file_time_type::clock::now();
+        auto past = now - std::chrono::hours(24);
+        LL1AnalysisCache cache(directory.string(), sizes[0] + sizes[1] + sizes[2] - 1);
+        htmlOf(cache, stream);
+        setTimeOfNewEntries(directory, past, now - std::chrono::hours(2));
+        htmlOf(cache, otherStream);
+        setTimeOfNewEntries(directory, now - std::chrono::minutes(90), now - std::chrono::hours(1));
+        htmlOf(cache, stream);
+        htmlOf(cache, conflictStream);
+        if (!isStatistics(cache, 1, 3, 3, 1) || directorySizeOf(directory) != sizes[0] + sizes[2]) {
+            printf("--test LL1AnalysisCache eviction failed--\n");
+            return 1;
+        }
+    }
+
+    // A temporary file left by a crash is removed, and the one being written is kept.
+    {
+        std::ofstream(directory / "0000000000000000.ll1.tmp1") << "stale";
+        std::ofstream(directory / "0000000000000000.ll1.tmp2") << "writing";
+        fs::last_write_time(directory / "0000000000000000.ll1.tmp1",
+                            fs::file_time_type::clock::now() - LL1AnalysisCache::staleAge - std::chrono::minutes(1));
+        LL1AnalysisCache cache(directory.string());
+        if (fs::exists(directory / "0000000000000000.ll1.tmp1") || !fs::exists(directory / "0000000000000000.ll1.tmp2")) {
+            printf("--test LL1AnalysisCache temporary file failed--\n");
+            return 1;
+        }
+    }
+
+    fs::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * The MIT License
+ *
+ * Copyright 2022 Krishna sssky307@163.com
+ *
+ * For the full copyright and license information, please view the LICENSE
+ * file that was distributed with this source code.
+ */
+
+#include "GrammarContextBuilder.h"
+#include "GrammarImage.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace csa;
+namespace fs = std::filesystem;
+
+// Every accessor of the image gives the same as the analyzer.
+bool isSameAnalysis(const GrammarImage &image, const LL1Analyzer &theLL1Analyzer) {
+    auto gc = theLL1Analyzer.grammarContext();
+    auto &st = *gc->st;
+    auto &pl = gc->pl->table();
+    if (!image.isAnalyzed() || image.symbolCount() != st.symbolCount() || image.productionCount() != pl.size()) {
+        return false;
+    }
+    auto isSameSet = [&](GrammarImage::Array<GrammarImage::Word> words, const SymbolSet &set) {
+        for (std::size_t id = 0; id < st.symbolCount(); ++id) {
+            if (GrammarImage::contains(words, id) != set.contains(id)) { return false; }
+        }
+        return true;
+    };
+    for (auto symbol : st.table()) {
+        auto id = symbol->id();
+        if (image.symbolName(id) != symbol->name() || image.symbolType(id) != symbol->getType() ||
+            image.isNillable(id) != symbol->isNillable() || !isSameSet(image.firstSet(id), symbol->firstSet()) ||
+            !isSameSet(image.followSet(id), symbol->followSet())) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < pl.size(); ++i) {
+        auto rhs = image.rhsOf(i);
+        if (image.lhsOf(i) != pl[i].lhs.symbol->id() || rhs.size() != pl[i].rhs.symbolList.size() ||
+            image.isRhsNillable(i) != pl[i].rhs.isNillable || !isSameSet(image.rhsFirstSet(i), pl[i].rhs.firstSet) ||
+            !isSameSet(image.predictSet(i), pl[i].rhs.predictSet)) {
+            return false;
+        }
+        for (std::size_t j = 0; j < rhs.size(); ++j) {
+            if (rhs[j] != pl[i].rhs.symbolList[j]->id()) { return false; }
+        }
+    }
+    auto &table = theLL1Analyzer.ll1Table();
+    if (image.rowCount() != table.rowCount() || image.columnCount() != table.columnCount()) { return false; }
+    for (std::size_t row = 0; row < table.rowCount(); ++row) {
+        if (image.rowSymbol(row) != table.nonterminals[row]->id()) { return false; }
+        for (std::size_t column = 0; column < table.columnCount(); ++column) {
+            if (image.columnSymbol(column) != table.terminals[column]->id() ||
+                image.cellAt(row, column) != table.at(row, column) ||
+                image.productionsAt(row, column) != table.productionsAt(row, column)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Build the grammar and its analysis from the image only, and get its html table.
+std::string htmlOf(const GrammarImage &image) {
+    auto gc = GrammarContextBuilder::buildFromImage(image);
+    if (!gc) { return {}; }
+    LL1Analyzer theLL1Analyzer(gc);
+    if (theLL1Analyzer.loadAnalysis(image) != 0) { return {}; }
+    return theLL1Analyzer.buildHtmlTable();
+}
+
+int main() {
+    std::string stream = R"(
+E   -> T E1
+E1  -> + T E1
+E1  -> epsilon
+T   -> F T1
+T1  -> * F T1
+T1  -> epsilon
+F   -> ( E )
+F   -> id
+)";
+    std::string conflictStream = "S -> a S\nS -> a\nS -> \"quoted name\" S\n";
+
+    for (auto &text : {stream, conflictStream}) {
+        auto gc = GrammarContextBuilder::buildFromStream(text);
+        LL1Analyzer theLL1Analyzer(gc);
+        std::string data;
+        GrammarImage image;
+        if (!gc || theLL1Analyzer.parse() != 0 || GrammarImage::write(theLL1Analyzer, data) != 0 ||
+            image.load(data) != 0 || !isSameAnalysis(image, theLL1Analyzer) ||
+            htmlOf(image) != theLL1Analyzer.buildHtmlTable()) {
+            printf("--test GrammarImage analysis failed--\n");
+            return 1;
+        }
+
+        // An image is only loaded by the same grammar.
+        auto other = GrammarContextBuilder::buildFromStream("S -> ( S ) S\nS -> epsilon\n");
+        LL1Analyzer otherLL1Analyzer(other);
+        if (otherLL1Analyzer.loadAnalysis(image) == 0 || otherLL1Analyzer.isParsed()) {
+            printf("--test GrammarImage other grammar failed--\n");
+            return 1;
+        }
+    }
+
+    // A file image is mapped, and a broken one can't be opened.
+    auto directory = fs::temp_directory_path() / "csa-test12-image";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    auto filename = (directory / "grammar.img").string();
+    auto textFilename = (directory / "grammar.txt").string();
+    {
+        auto gc = GrammarContextBuilder::buildFromStream(stream);
+        LL1Analyzer theLL1Analyzer(gc);
+        theLL1Analyzer.parse();
+        std::ofstream(textFilename) << stream;
+        GrammarImage image;
+        if (GrammarImage::writeToFile(theLL1Analyzer, filename) != 0 || !GrammarImage::isImageFile(filename) ||
+            GrammarImage::isImageFile(textFilename) || image.open(filename) != 0 ||
+            image.byteSize() != fs::file_size(filename) || htmlOf(image) != theLL1Analyzer.buildHtmlTable()) {
+            printf("--test GrammarImage file failed--\n");
+            return 1;
+        }
+
+        std::string data;
+        GrammarImage::write(theLL1Analyzer, data);
+        auto truncated = data.substr(0, data.size() - 8);
+        auto otherVersion = data;
+        otherVersion[8] = static_cast<char>(GrammarImage::version + 1);
+        auto badSymbol = data;
+        badSymbol.replace(data.find("id"), 2, "i\0", 2);
+        if (image.load(truncated) == 0 || image.load(otherVersion) == 0 || image.load(badSymbol) == 0 ||
+            image.isOpen() || image.open(textFilename) == 0) {
+            printf("--test GrammarImage broken image failed--\n");
+            return 1;
+        }
+    }
+
+    // A grammar which is not analyzed has only its grammar context.
+    {
+        auto gc = GrammarContextBuilder::buildFromStream(stream);
+        LL1Analyzer theLL1Analyzer(gc);
+        std::string data;
+        GrammarImage image;
+        if (GrammarImage::write(theLL1Analyzer, data) != 0 || image.load(data) != 0 || image.isAnalyzed() ||
+            image.rowCount() != 0 || !image.firstSet(1).empty()) {
+            printf("--test GrammarImage grammar only failed--\n");
+            return 1;
+        }
+        auto imageGc = GrammarContextBuilder::buildFromImage(image);
+        LL1Analyzer imageLL1Analyzer(imageGc);
+        theLL1Analyzer.parse();
+        if (!imageGc || imageLL1Analyzer.loadAnalysis(image) == 0 || imageLL1Analyzer.parse() != 0 ||
+            imageLL1Analyzer.buildHtmlTable() != theLL1Analyzer.buildHtmlTable()) {
+            printf("--test GrammarImage grammar only failed--\n");
+            return 1;
+        }
+    }
+
+    fs::remove_all(directory);
+    return 0;
+}
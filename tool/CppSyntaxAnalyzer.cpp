@@ -10,29 +10,83 @@
 #include "config.h"
 #include "miniopt.h"
 #include "GrammarContextBuilder.h"
+#include "GrammarImage.h"
+#include "LL1AnalysisCache.h"
 #include "LL1Analyzer.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 using namespace csa;
+namespace fs = std::filesystem;
 
-int StreamToFile(const std::string& stream, std::string filename){
-    if(stream.empty() || filename.empty()){
-        return 1;
+using Builder = std::function<int(OutputSink&)>;
+
+struct Options {
+    std::vector<std::string> inputs;    ///< Grammar files or directories.
+    std::string list;                   ///< A file lists the grammar files, one per line.
+    std::string out;                    ///< Output file, or output directory in batch mode.
+    std::string className;              ///< Generate a parser class instead of the html table.
+    std::string image;                  ///< Write the grammar image of the analyzed grammar to it.
+    std::string format = "html";        ///< Format of the analysis output: html, json or csv.
+    std::size_t jobs = 1;               ///< Count of the threads.
+    bool isWatch = false;               ///< Analyze the grammar file again whenever it changes.
+    std::shared_ptr<LL1AnalysisCache> cache;    ///< Cache of the analysis results, it can be nullptr.
+
+    bool isBatch() const {
+        std::error_code ec;
+        return inputs.size() > 1 || !list.empty() || (inputs.size() == 1 && fs::is_directory(inputs.front(), ec));
     }
+};
 
-    std::string suffix = ".html";
+/**
+ * @brief Get the suffix of the output file, by the format or the generated parser.
+ */
+std::string OutputSuffix(const Options& options){
+    return options.className.empty() ? "." + options.format : ".h";
+}
+
+std::string AddSuffix(std::string filename, const std::string& suffix){
     auto suffixSize = suffix.size();
     auto filenameSize = filename.size();
     if(filenameSize < suffixSize || filename.substr(filenameSize - suffixSize) != suffix){
         filename += suffix;
     }
+    return filename;
+}
+
+int BuildToFile(const Builder& build, std::string filename, const std::string& suffix){
+    if(filename.empty()){
+        return 1;
+    }
+
+    filename = AddSuffix(std::move(filename), suffix);
 
     std::ofstream ofs(filename);
     if(ofs){
-        ofs << stream;
-        ofs.flush();
-        ofs.close();
+        StreamOutputSink sink(ofs);
+        if(build(sink) != 0){
+            printf("error: cannot write file = %s\n", filename.c_str());
+            return 1;
+        }
     }else{
         printf("error: cannot write file = %s\n", filename.c_str());
         return 1;
@@ -41,46 +95,497 @@ int StreamToFile(const std::string& stream, std::string filename){
     return 0;
 }
 
-std::string ReadStreamFromStdin(){
-    std::string stream;
-    std::string line;
-    while(std::getline(std::cin,line)){
-        stream += line + "\n";
+int BuildToStdout(const Builder& build){
+    StreamOutputSink sink(std::cout);
+    if(build(sink) != 0){ return 1; }
+    sink.flush();
+    std::cout << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Build a grammar from a grammar file, or from a grammar image which is opened into the image.
+ */
+GrammarContextPtr BuildGrammar(const std::string& input, GrammarImage& image){
+    if(GrammarImage::isImageFile(input)){
+        if(image.open(input) != 0){
+            printf("error: invalid grammar image = %s\n", input.c_str());
+            return {};
+        }
+        return GrammarContextBuilder::buildFromImage(image);
+    }
+    return GrammarContextBuilder::buildFromFile(input);
+}
+
+/**
+ * @brief Analyze a grammar, the results are loaded from its image or the cache if they have them.
+ */
+int ParseGrammar(LL1Analyzer& theLL1Analyzer, const Options& options, const GrammarImage* image){
+    if(image && image->isOpen() && image->isAnalyzed()){
+        return theLL1Analyzer.loadAnalysis(*image);
+    }
+    if(options.cache){
+        return options.cache->parse(theLL1Analyzer);
+    }
+    return theLL1Analyzer.parse();
+}
+
+void PrintCacheStatistics(const Options& options, FILE* file){
+    if(!options.cache){ return; }
+    auto statistics = options.cache->statistics();
+    fprintf(file, "[cache] %s hit = %zu, miss = %zu, store = %zu, eviction = %zu\n",
+            options.cache->directory().c_str(), statistics.hitCount, statistics.missCount, statistics.storeCount,
+            statistics.evictionCount);
+}
+
+/**
+ * @brief Get the builder of the output, the analysis in its format or the generated parser.
+ *
+ * @param[in] theLL1Analyzer    The analyzed grammar, it must live longer than the builder.
+ * @param[in] options           Options.
+ */
+Builder MakeBuilder(LL1Analyzer& theLL1Analyzer, const Options& options){
+    if(!options.className.empty()){
+        return [&theLL1Analyzer, &options](OutputSink& sink){ return theLL1Analyzer.buildCppParser(sink, options.className); };
+    }
+    if(options.format != "html"){
+        auto format = options.format == "json" ? LL1Analyzer::RecordFormat::json : LL1Analyzer::RecordFormat::csv;
+        return [&theLL1Analyzer, format](OutputSink& sink){ return theLL1Analyzer.buildRecords(sink, format); };
+    }
+    return [&theLL1Analyzer](OutputSink& sink){ return theLL1Analyzer.buildHtmlTable(sink); };
+}
+
+/**
+ * @brief Analyze a grammar, and write the html table or the generated parser.
+ *
+ * @param[in] gc            The grammar.
+ * @param[in] options       Options.
+ * @param[in] out           Output file, empty means stdout.
+ * @param[in] jobs          Count of the threads used by the analyzer.
+ * @param[out] isLL1        Is the grammar LL(1), it can be nullptr.
+ * @param[in] image         The grammar image which gc is built from, it can be nullptr.
+ */
+int Analyze(GrammarContextPtr gc, const Options& options, const std::string& out, std::size_t jobs, bool* isLL1,
+            const GrammarImage* image){
+    LL1Analyzer theLL1Analyzer(gc);
+    theLL1Analyzer.setJobs(jobs);
+    if(ParseGrammar(theLL1Analyzer, options, image) != 0){ return 1; }
+    if(isLL1){ *isLL1 = !theLL1Analyzer.ll1Table().hasConflict(); }
+    if(!options.image.empty() && GrammarImage::writeToFile(theLL1Analyzer, options.image) != 0){
+        printf("error: cannot write file = %s\n", options.image.c_str());
+        return 1;
+    }
+
+    auto build = MakeBuilder(theLL1Analyzer, options);
+    if(!out.empty()){
+        return BuildToFile(build, out, OutputSuffix(options));
+    }else{
+        return BuildToStdout(build);
     }
-    return stream;
 }
 
-int DoWork(std::string in, std::string out){
+int DoWork(const Options& options){
     GrammarContextPtr gc;
+    GrammarImage image;
 
-    if(in.empty()){
-        auto stream = ReadStreamFromStdin();
-        gc = GrammarContextBuilder::buildFromStream(stream);
+    if(options.inputs.empty()){
+        gc = GrammarContextBuilder::buildFromFile(stdin);
     }else{
-        gc = GrammarContextBuilder::buildFromFile(in);
+        gc = BuildGrammar(options.inputs.front(), image);
     }
 
     if(gc){
-        LL1Analyzer theLL1Analyzer(gc);
-        if(theLL1Analyzer.parse() == 0){
-            auto stream = theLL1Analyzer.buildHtmlTable();
-            if(!out.empty()){
-                return StreamToFile(stream, out);
+        auto status = Analyze(gc, options, options.out, options.jobs, nullptr, &image);
+        PrintCacheStatistics(options, stderr);
+        return status;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief A grammar file of the batch.
+ */
+struct BatchFile {
+    std::string input;          ///< Grammar file.
+    std::string out;            ///< Output file, empty if there is no output directory.
+    int status = 1;             ///< 0 means pass.
+    bool isLL1 = false;         ///< Is the grammar LL(1).
+    std::size_t productionCount = 0;
+    double seconds = 0;
+};
+
+/**
+ * @brief Collect the grammar files of the batch.
+ *
+ * A directory gives all the regular files under it in name order, and their outputs keep
+ * the paths relative to the directory. A file gives its output by its filename.
+ */
+int CollectBatchFiles(const Options& options, std::vector<BatchFile>& files){
+    auto inputs = options.inputs;
+    if(!options.list.empty()){
+        std::ifstream ifs(options.list);
+        if(!ifs){
+            printf("error: cannot read file = %s\n", options.list.c_str());
+            return 1;
+        }
+        std::string line;
+        while(std::getline(ifs, line)){
+            if(!line.empty() && line.back() == '\r'){ line.pop_back(); }
+            if(line.empty() || line.front() == '#'){ continue; }
+            inputs.push_back(line);
+        }
+    }
+
+    auto add = [&](const fs::path& input, const fs::path& name){
+        BatchFile file;
+        file.input = input.string();
+        if(!options.out.empty()){ file.out = AddSuffix((fs::path(options.out) / name).string(), OutputSuffix(options)); }
+        files.push_back(std::move(file));
+    };
+
+    for(auto& input : inputs){
+        std::error_code ec;
+        if(fs::is_directory(input, ec)){
+            std::vector<fs::path> paths;
+            for(auto& entry : fs::recursive_directory_iterator(input, ec)){
+                if(entry.is_regular_file()){ paths.push_back(entry.path()); }
+            }
+            if(ec){
+                printf("error: cannot read directory = %s\n", input.c_str());
+                return 1;
+            }
+            std::sort(paths.begin(), paths.end());
+            for(auto& path : paths){ add(path, path.lexically_relative(input)); }
+        }else{
+            add(input, fs::path(input).filename());
+        }
+    }
+
+    // Two inputs can't write the same output, their outputs have got the suffix.
+    std::set<std::string> outs;
+    for(auto& file : files){
+        if(!file.out.empty() && !outs.insert(file.out).second){
+            printf("error: more than one input writes output = %s\n", file.out.c_str());
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Analyze many grammar files on a thread pool, then print a summary.
+ *
+ * Every grammar is analyzed by one thread, so the files are the unit of parallelism.
+ * Without an output directory, the grammars are only analyzed.
+ */
+int DoBatchWork(const Options& options){
+    std::vector<BatchFile> files;
+    if(CollectBatchFiles(options, files) != 0){ return 1; }
+
+    if(!options.out.empty()){
+        std::error_code ec;
+        for(auto& file : files){
+            auto parent = fs::path(file.out).parent_path();
+            if(!parent.empty()){ fs::create_directories(parent, ec); }
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool<std::size_t> pool(options.jobs);
+    for(std::size_t i = 0; i < files.size(); ++i){ pool.push(i % pool.workerCount(), i); }
+    pool.run([&](std::size_t i, std::size_t){
+        auto& file = files[i];
+        auto fileStart = std::chrono::steady_clock::now();
+        GrammarImage image;
+        auto gc = BuildGrammar(file.input, image);
+        if(gc){
+            file.productionCount = gc->pl->table().size();
+            if(file.out.empty()){
+                LL1Analyzer theLL1Analyzer(gc);
+                file.status = ParseGrammar(theLL1Analyzer, options, &image);
+                file.isLL1 = file.status == 0 && !theLL1Analyzer.ll1Table().hasConflict();
             }else{
-                std::cout << stream << std::endl;
-                return 0;
+                file.status = Analyze(gc, options, file.out, 1, &file.isLL1, &image);
+            }
+        }
+        file.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - fileStart).count();
+    });
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    std::size_t passCount = 0;
+    std::size_t ll1Count = 0;
+    for(auto& file : files){
+        printf("[%s] %s productions = %zu, %s, %.3fs\n", file.status == 0 ? "pass" : "fail", file.input.c_str(),
+               file.productionCount, file.isLL1 ? "LL(1)" : "not LL(1)", file.seconds);
+        if(file.status == 0){ ++passCount; }
+        if(file.isLL1){ ++ll1Count; }
+    }
+    printf("[summary] files = %zu, pass = %zu, fail = %zu, LL(1) = %zu, jobs = %zu, %.3fs\n", files.size(),
+           passCount, files.size() - passCount, ll1Count, pool.workerCount(), seconds.count());
+    PrintCacheStatistics(options, stdout);
+
+    return passCount == files.size() ? 0 : 1;
+}
+
+/**
+ * @brief The grammar of the watch mode, it stays in memory between the changes of the file.
+ */
+struct WatchedGrammar {
+    GrammarContextPtr gc;
+    std::unique_ptr<LL1Analyzer> analyzer;    ///< Analysis of gc, nullptr if there is none.
+    std::string text;                         ///< The last output.
+};
+
+bool IsSameProduction(const Production& a, const Production& b){
+    if(a.lhs.symbol->name() != b.lhs.symbol->name() || a.rhs.symbolList.size() != b.rhs.symbolList.size()){
+        return false;
+    }
+    for(std::size_t i = 0; i < a.rhs.symbolList.size(); ++i){
+        if(a.rhs.symbolList[i]->name() != b.rhs.symbolList[i]->name()){ return false; }
+    }
+    return true;
+}
+
+/**
+ * @brief Can the productions [prefix, prefix + removeCount) of the watched grammar be replaced by
+ * the productions [prefix, prefix + addCount) of the new grammar.
+ *
+ * The new productions are added before the old ones are removed, so no new production may be
+ * an old one which is replaced, and every nonterminal of the old productions must still have a
+ * production, otherwise the analyzer would refuse the edit.
+ *
+ * The edited analysis must be the same as a fresh one: every symbol keeps its type, and the
+ * symbols keep the id order of a fresh grammar context, since the sets are written in id order.
+ * New symbols get ids after the old ones, and a new nonterminal must be added by its own
+ * production before it is used. A removed production leaves its symbols in the symbol table,
+ * so every old symbol must still be in the new grammar, or the records would list it.
+ */
+bool IsEditable(const WatchedGrammar& watched, GrammarContextPtr gc, std::size_t prefix, std::size_t removeCount,
+                std::size_t addCount){
+    auto& oldPl = watched.gc->pl->table();
+    auto& pl = gc->pl->table();
+    std::unordered_set<std::string_view> lhsNames;
+    for(auto& p : pl){ lhsNames.insert(p.lhs.symbol->name()); }
+    for(auto i = prefix; i < prefix + removeCount; ++i){
+        if(lhsNames.count(oldPl[i].lhs.symbol->name()) == 0){ return false; }
+        for(auto j = prefix; j < prefix + addCount; ++j){
+            if(IsSameProduction(oldPl[i], pl[j])){ return false; }
+        }
+    }
+
+    std::unordered_map<std::string_view, SymbolPtr> oldSymbols;
+    for(auto symbol : watched.gc->st->table()){ oldSymbols.emplace(symbol->name(), symbol); }
+
+    std::unordered_map<std::string_view, bool> isDefinedFirst;
+    for(auto i = prefix; i < prefix + addCount; ++i){
+        isDefinedFirst.emplace(pl[i].lhs.symbol->name(), true);
+        for(auto symbol : pl[i].rhs.symbolList){ isDefinedFirst.emplace(symbol->name(), false); }
+    }
+
+    SymbolId lastId = 0;
+    bool hasNewSymbol = false;
+    std::size_t keptCount = 0;
+    for(auto symbol : gc->st->table()){
+        auto it = oldSymbols.find(symbol->name());
+        if(it == oldSymbols.end()){
+            hasNewSymbol = true;
+            if(symbol->isNonterminal() && !isDefinedFirst[symbol->name()]){ return false; }
+            continue;
+        }
+        auto oldSymbol = it->second;
+        if(hasNewSymbol || oldSymbol->getType() != symbol->getType() || (lastId > 0 && oldSymbol->id() <= lastId)){
+            return false;
+        }
+        lastId = oldSymbol->id();
+        ++keptCount;
+    }
+    return keptCount == oldSymbols.size();
+}
+
+/**
+ * @brief Edit the watched grammar into the new grammar, only the changed productions are analyzed.
+ *
+ * The new productions between the common prefix and the common suffix are added at the ids of
+ * the old ones, then the old ones are removed, so the production ids follow the file like a
+ * fresh analysis, and a nonterminal never loses its last production on the way.
+ *
+ * @return int  Count of the edited productions, or -1 if the new grammar needs a fresh analysis.
+ */
+int EditGrammar(WatchedGrammar& watched, GrammarContextPtr gc){
+    auto& oldPl = watched.gc->pl->table();
+    auto& newPl = gc->pl->table();
+    std::size_t prefix = 0;
+    while(prefix < oldPl.size() && prefix < newPl.size() && IsSameProduction(oldPl[prefix], newPl[prefix])){
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while(prefix + suffix < oldPl.size() && prefix + suffix < newPl.size() &&
+          IsSameProduction(oldPl[oldPl.size() - 1 - suffix], newPl[newPl.size() - 1 - suffix])){
+        ++suffix;
+    }
+
+    // The start production can't be edited, and every edit may scan the LL(1) table,
+    // so a fresh analysis is faster than many edits.
+    constexpr std::size_t maxEditCount = 16;
+    auto removeCount = oldPl.size() - prefix - suffix;
+    auto addCount = newPl.size() - prefix - suffix;
+    if(prefix == 0 || removeCount + addCount > maxEditCount || (removeCount + addCount) * 2 > newPl.size() ||
+       !IsEditable(watched, gc, prefix, removeCount, addCount)){
+        return -1;
+    }
+
+    for(std::size_t i = 0; i < addCount; ++i){
+        auto& p = newPl[prefix + i];
+        std::vector<std::string_view> rhs;
+        for(auto symbol : p.rhs.symbolList){ rhs.push_back(symbol->name()); }
+        if(watched.analyzer->addProduction(p.lhs.symbol->name(), rhs, static_cast<int>(prefix + i)) < 0){
+            return -1;
+        }
+    }
+    for(auto i = prefix + addCount + removeCount; i > prefix + addCount; --i){
+        if(watched.analyzer->removeProduction(static_cast<int>(i - 1)) != 0){ return -1; }
+    }
+    return static_cast<int>(removeCount + addCount);
+}
+
+/**
+ * @brief Analyze the changed grammar file, and write the output only if it is changed.
+ *
+ * A file which can't be parsed keeps the last analysis and output.
+ */
+void UpdateWatchedGrammar(WatchedGrammar& watched, const Options& options){
+    auto start = std::chrono::steady_clock::now();
+    auto& input = options.inputs.front();
+    auto gc = GrammarContextBuilder::buildFromFile(input);
+    if(!gc){
+        fprintf(stderr, "[watch] cannot parse %s, the last output is kept\n", input.c_str());
+        return;
+    }
+
+    int edits = watched.analyzer ? EditGrammar(watched, gc) : -1;
+    if(edits < 0){
+        watched.gc = gc;
+        watched.analyzer = std::make_unique<LL1Analyzer>(gc);
+        watched.analyzer->setJobs(options.jobs);
+        if(watched.analyzer->parse() != 0){
+            watched.analyzer.reset();
+            fprintf(stderr, "[watch] cannot analyze %s, the last output is kept\n", input.c_str());
+            return;
+        }
+    }
+
+    // The same productions give the same output.
+    bool isChanged = false;
+    if(edits != 0){
+        std::string text;
+        auto build = MakeBuilder(*watched.analyzer, options);
+        {
+            StringOutputSink sink(text);
+            if(build(sink) != 0 || !sink.flush()){ return; }
+        }
+        if(text != watched.text){
+            isChanged = true;
+            watched.text = std::move(text);
+            Builder write = [&watched](OutputSink& sink){ sink << watched.text; return sink.flush() ? 0 : 1; };
+            if(!options.out.empty()){
+                BuildToFile(write, options.out, OutputSuffix(options));
+            }else{
+                BuildToStdout(write);
             }
         }
     }
 
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    auto analysis = edits < 0 ? std::string("full analysis") : std::to_string(edits) + " productions edited";
+    fprintf(stderr, "[watch] %s, %.3fms, output %s\n", analysis.c_str(), seconds.count() * 1000,
+            isChanged ? "updated" : "unchanged");
+}
+
+/**
+ * @brief Analyze the grammar file, then analyze it again whenever it changes, until killed.
+ *
+ * The grammar and its analysis stay in memory, and only the changed productions are analyzed.
+ * The directory of the file is watched, so editors which save by renaming are also seen.
+ */
+int DoWatchWork(const Options& options){
+    if(options.inputs.size() != 1 || options.isBatch()){
+        printf("error: watch mode needs one grammar file\n");
+        return 1;
+    }
+
+#if defined(__linux__)
+    auto path = fs::path(options.inputs.front());
+    auto directory = path.parent_path().empty() ? fs::path(".") : path.parent_path();
+    auto filename = path.filename().string();
+
+    int fd = inotify_init1(IN_CLOEXEC);
+    if(fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0){
+        printf("error: cannot watch file = %s\n", options.inputs.front().c_str());
+        if(fd >= 0){ close(fd); }
+        return 1;
+    }
+
+    WatchedGrammar watched;
+    UpdateWatchedGrammar(watched, options);
+
+    // A save may come with many events, they are collected until the file is quiet for a moment.
+    constexpr int quietMilliseconds = 20;
+    alignas(inotify_event) char buffer[4096];
+    pollfd pfd{fd, POLLIN, 0};
+    while(true){
+        bool isChanged = false;
+        int ready;
+        while((ready = poll(&pfd, 1, isChanged ? quietMilliseconds : -1)) > 0){
+            auto size = read(fd, buffer, sizeof(buffer));
+            if(size <= 0){ break; }
+            for(auto p = buffer; p < buffer + size; ){
+                auto event = reinterpret_cast<const inotify_event*>(p);
+                if(event->len > 0 && filename == event->name){ isChanged = true; }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        if(ready < 0 && errno != EINTR){
+            printf("error: cannot watch file = %s\n", options.inputs.front().c_str());
+            close(fd);
+            return 1;
+        }
+        if(isChanged){ UpdateWatchedGrammar(watched, options); }
+    }
+#else
+    printf("error: watch mode is only supported on linux\n");
     return 1;
+#endif
+}
+
+/**
+ * @brief Parse a positive count of digits only.
+ *
+ * @return bool     false if it is not a positive count, or it is greater than max.
+ */
+bool ParseCount(const std::string& text, std::uintmax_t max, std::uintmax_t& count){
+    if(text.empty() || text.find_first_not_of("0123456789") != std::string::npos){
+        return false;
+    }
+    errno = 0;
+    count = std::strtoumax(text.c_str(), nullptr, 10);
+    return errno == 0 && count > 0 && count <= max;
 }
 
 int ParseArgs(int argc, char *argv[]) {
     option options[] = {
         {'o', "out", "<file>", ""},
         {'v', "version", nil, ""},
-        {'h', "help", nil, ""}
+        {'h', "help", nil, ""},
+        {'g', "generate", "<class>", ""},
+        {'j', "jobs", "<n>", ""},
+        {'l', "list", "<file>", ""},
+        {'w', "watch", nil, ""},
+        {'c', "cache", "<dir>", ""},
+        {'s', "cache-size", "<mb>", ""},
+        {'i', "image", "<file>", ""},
+        {'f', "format", "<format>", ""}
     };
     const int optsum = sizeof(options) / sizeof(options[0]);
 
@@ -89,14 +594,15 @@ int ParseArgs(int argc, char *argv[]) {
         return 1;
     }
 
-    std::string in;
-    std::string out;
+    Options theOptions;
+    std::string cacheDirectory;
+    std::uintmax_t cacheSize = LL1AnalysisCache::defaultMaxBytes >> 20;
     int status;
     while ((status = miniopt.getopt()) > 0) {
         int id = miniopt.optind();
         switch (id) {
             case 0: // -o --out <file>
-                out = miniopt.optarg();
+                theOptions.out = miniopt.optarg();
             break;
             case 1: // -v --version
                 std::cout << config::VersionStr << "\n";
@@ -104,8 +610,49 @@ int ParseArgs(int argc, char *argv[]) {
             case 2: // -h --help
                 std::cout << config::HelpStr << "\n";
                 return 0;
+            case 3: // -g --generate <class>
+                theOptions.className = miniopt.optarg();
+            break;
+            case 4: // -j --jobs <n>
+            {
+                // More threads than the hardware runs only cost memory, so they are clamped.
+                std::uintmax_t jobs;
+                if(!ParseCount(miniopt.optarg(), UINTMAX_MAX, jobs)){
+                    printf("error: invalid jobs = %s\n", miniopt.optarg());
+                    return 1;
+                }
+                std::uintmax_t maxJobs = 4 * std::max(1u, std::thread::hardware_concurrency());
+                theOptions.jobs = static_cast<std::size_t>(std::min(jobs, maxJobs));
+            }
+            break;
+            case 5: // -l --list <file>
+                theOptions.list = miniopt.optarg();
+            break;
+            case 6: // -w --watch
+                theOptions.isWatch = true;
+            break;
+            case 7: // -c --cache <dir>
+                cacheDirectory = miniopt.optarg();
+            break;
+            case 8: // -s --cache-size <mb>
+                // It is in megabytes, so it must not overflow when it is shifted into bytes.
+                if(!ParseCount(miniopt.optarg(), UINTMAX_MAX >> 20, cacheSize)){
+                    printf("error: invalid cache size = %s\n", miniopt.optarg());
+                    return 1;
+                }
+            break;
+            case 9: // -i --image <file>
+                theOptions.image = miniopt.optarg();
+            break;
+            case 10: // -f --format <format>
+                theOptions.format = miniopt.optarg();
+                if(theOptions.format != "html" && theOptions.format != "json" && theOptions.format != "csv"){
+                    printf("error: invalid format = %s\n", miniopt.optarg());
+                    return 1;
+                }
+            break;
             default:
-            if(in.empty()){ in = miniopt.optarg(); }
+            theOptions.inputs.push_back(miniopt.optarg());
             break;
         }
     }
@@ -115,7 +662,22 @@ int ParseArgs(int argc, char *argv[]) {
         return status;
     }
 
-    return DoWork(in, out);
+    if(!cacheDirectory.empty()){
+        theOptions.cache = std::make_shared<LL1AnalysisCache>(cacheDirectory, cacheSize << 20);
+    }
+
+    if(!theOptions.className.empty() && theOptions.format != "html"){
+        printf("error: a generated parser has no format\n");
+        return 1;
+    }
+
+    if(!theOptions.image.empty() && (theOptions.isWatch || theOptions.isBatch())){
+        printf("error: grammar image needs one grammar file\n");
+        return 1;
+    }
+
+    if(theOptions.isWatch){ return DoWatchWork(theOptions); }
+    return theOptions.isBatch() ? DoBatchWork(theOptions) : DoWork(theOptions);
 }
 
 int main(int argc, char* argv[]){